@@ -2,17 +2,84 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
 #include <exception>
 #include <format>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <optional>
+#include <random>
+#include <ranges>
 #include <source_location>
+#include <span>
+#include <stdexcept>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DOUGH_POSIX 1
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define DOUGH_POSIX 0
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DOUGH_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define DOUGH_COLD __declspec(noinline)
+#else
+#define DOUGH_COLD
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
 
 /**
 * @brief main dough namespace
@@ -52,34 +119,381 @@ namespace dough
         concept except_mode = std::is_same_v<T, std::true_type> || std::is_same_v<T, std::false_type>;
 
         /**
-        * @brief formats fail message
+        * @struct alloc_counters
+        * @brief heap allocations of one thread, counted by the replaced operator new and delete
         */
-        template<class T1, class T2>
-        std::string fail_format(
-            const std::string& message,
-            const std::string& check_type,
-            const std::source_location& location,
-            T1 expected,
-            T2 actual)
+        struct alloc_counters
         {
-            std::stringstream result;
-            result << std::boolalpha;
-            result.precision(10);
+            std::uint64_t allocations = 0;      // blocks allocated
+            std::uint64_t frees = 0;            // blocks freed
+            std::uint64_t bytes = 0;            // bytes allocated
+            std::int64_t live = 0;              // bytes allocated minus freed, negative if other threads' blocks were freed
+            std::int64_t peak = 0;              // highest live so far
+        };
+
+        /**
+        * @brief allocations of the calling thread. trivial, so operator new can use it at any time
+        */
+        inline thread_local alloc_counters alloc_stats;
 
-            result <<
-                "[FAIL ] Failed check : " << check_type << '\n' <<
-                "        File         : " << std::string(location.file_name()) << '\n' <<
-                "        Line         : " << location.line() << '\n' <<
-                "        Expected     : " << expected << '\n' <<
-                "        Actual       : " << actual << '\n' <<
-                "        Message      : " << message << "\n\n";
+        /**
+        * @brief whether operator new and delete are replaced by the tracking ones, see DOUGH_TRACK_ALLOCATIONS
+        */
+        inline std::atomic<bool> alloc_tracking = false;
 
-            return result.str();
+        inline void alloc_record(std::size_t size) noexcept
+        {
+            auto& stats = alloc_stats;
+            stats.allocations++;
+            stats.bytes += size;
+            stats.live += static_cast<std::int64_t>(size);
+            if (stats.live > stats.peak) stats.peak = stats.live;
+        }
+
+        inline void free_record(std::size_t size) noexcept
+        {
+            auto& stats = alloc_stats;
+            stats.frees++;
+            stats.live -= static_cast<std::int64_t>(size);
+        }
+
+        /**
+        * @brief allocations of the calling thread are left out of the counters while above zero
+        */
+        inline thread_local unsigned alloc_paused = 0;
+
+        /**
+        * @class alloc_pause
+        * @brief leaves the framework's own allocations on the calling thread out of the per-test counts
+        * while alive. blocks allocated meanwhile are not counted when they are freed either, on any thread
+        */
+        class alloc_pause
+        {
+        public:
+            alloc_pause() noexcept { ++alloc_paused; }
+            ~alloc_pause() { --alloc_paused; }
+
+            alloc_pause(const alloc_pause&) = delete;
+            alloc_pause& operator=(const alloc_pause&) = delete;
+        };
+
+        /**
+        * @struct alloc_usage
+        * @brief heap usage of a test, all zero unless allocations are tracked
+        */
+        struct alloc_usage
+        {
+            std::uint64_t allocations = 0;      // blocks allocated
+            std::uint64_t bytes = 0;            // bytes allocated
+            std::uint64_t peak = 0;             // most bytes alive at once, over what was alive at the start
+            std::uint64_t leaked = 0;           // blocks still alive at the end
+
+            /**
+            * @brief add usage of another thread or test, peaks are not summed but the highest is kept
+            */
+            alloc_usage& operator+=(const alloc_usage& other) noexcept
+            {
+                allocations += other.allocations;
+                bytes += other.bytes;
+                peak = std::max(peak, other.peak);
+                leaked += other.leaked;
+                return *this;
+            }
+        };
+
+        /**
+        * @class alloc_scope
+        * @brief counts the heap allocations of the calling thread from construction to stop(). 
+        * blocks freed by other threads count as leaked
+        */
+        class alloc_scope
+        {
+        public:
+            alloc_scope() noexcept
+                : start(alloc_stats), outer_peak(alloc_stats.peak)
+            {
+                alloc_stats.peak = alloc_stats.live;
+            }
+
+            alloc_usage stop() noexcept
+            {
+                auto& now = alloc_stats;
+                std::uint64_t allocations = now.allocations - start.allocations,
+                    frees = now.frees - start.frees;
+
+                alloc_usage usage{ allocations, now.bytes - start.bytes,
+                    static_cast<std::uint64_t>(std::max<std::int64_t>(now.peak - start.live, 0)), allocations > frees ? allocations - frees : 0 };
+                // an enclosing scope still sees the peak of this one
+                now.peak = std::max(now.peak, outer_peak);
+                return usage;
+            }
+
+        private:
+            alloc_counters start;
+            std::int64_t outer_peak;
+        };
+
+        /**
+        * @brief stream a report message is written to
+        */
+        enum class stream { out, err };
+
+        /**
+        * @class output
+        * @brief reporting pipeline. while started, messages from any thread go through a lock-free
+        * multi-producer queue to a writer thread that writes them in large batches; otherwise they
+        * are written directly. queued messages are written on stop, on exit and on fatal signals.
+        * start and stop must not be called while other threads are still reporting
+        */
+        class output
+        {
+        public:
+            /**
+            * @brief the process-wide pipeline
+            */
+            static output& instance()
+            {
+                static output pipeline;
+                return pipeline;
+            }
+
+            output(const output&) = delete;
+            output& operator=(const output&) = delete;
+
+            ~output()
+            {
+                stop();
+                delete tail;
+            }
+
+            /**
+            * @brief queue a message, or write it directly if the writer is not running
+            */
+            void write(stream target, std::string text)
+            {
+                if (!running.load(std::memory_order_acquire))
+                {
+                    (target == stream::out ? std::cout : std::cerr) << text;
+                    return;
+                }
+
+                node* n;
+                {
+                    // the writer frees it, so it must not count for the test that printed
+                    alloc_pause pause;
+                    n = new node{ target, std::move(text) };
+                }
+                node* prev = head.exchange(n, std::memory_order_acq_rel);
+                prev->next.store(n);
+                pushed.fetch_add(1, std::memory_order_release);
+
+                // wake the writer only if it went to sleep
+                if (idle.exchange(false)) idle.notify_one();
+            }
+
+            /**
+            * @brief start the writer thread
+            */
+            void start()
+            {
+                if (running.load()) return;
+
+                std::cout.flush();
+                stopping.store(false);
+                {
+                    alloc_pause pause;
+                    writer = std::thread([this]() { drain(); });
+                }
+                for (size_t i = 0; i < fatal_signals.size(); ++i)
+                {
+                    previous[i] = std::signal(fatal_signals[i], on_fatal_signal);
+                }
+                running.store(true, std::memory_order_release);
+            }
+
+            /**
+            * @brief write everything queued and stop the writer thread
+            */
+            void stop()
+            {
+                if (!running.exchange(false)) return;
+
+                for (size_t i = 0; i < fatal_signals.size(); ++i)
+                {
+                    std::signal(fatal_signals[i], previous[i] == SIG_ERR ? SIG_DFL : previous[i]);
+                }
+                stopping.store(true);
+                if (idle.exchange(false)) idle.notify_one();
+                writer.join();
+            }
+
+            /**
+            * @brief wait until everything queued so far is written, at most for the given time.
+            * only spins on atomics, so it can be called from a signal handler
+            */
+            bool flush(std::chrono::nanoseconds timeout) const noexcept
+            {
+                auto target = pushed.load(std::memory_order_acquire);
+                auto deadline = std::chrono::steady_clock::now() + timeout;
+                while (written.load(std::memory_order_acquire) < target)
+                {
+                    if (std::chrono::steady_clock::now() > deadline) return false;
+                    std::this_thread::yield();
+                }
+                return true;
+            }
+
+            /**
+            * @brief whether messages currently go through the writer thread
+            */
+            bool async() const noexcept
+            {
+                return running.load(std::memory_order_acquire);
+            }
+
+        private:
+            /**
+            * @struct node
+            * @brief queued message. the consumed node stays in the queue as its dummy head
+            */
+            struct node
+            {
+                stream target = stream::out;
+                std::string text;
+                std::atomic<node*> next{ nullptr };
+            };
+
+            output() = default;
+
+            /**
+            * @brief writer thread loop: joins queued messages into batches per stream,
+            * sleeps while the queue is empty
+            */
+            void drain()
+            {
+                std::string batch;
+                stream target = stream::out;
+                std::uint64_t count = 0;
+
+                auto write_batch = [&]()
+                    {
+                        if (batch.empty()) return;
+                        auto& out = (target == stream::out ? std::cout : std::cerr);
+                        out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                        out.flush();
+                        batch.clear();
+                    };
+
+                while (true)
+                {
+                    while (node* next = tail->next.load(std::memory_order_acquire))
+                    {
+                        // keep the order of out and err messages
+                        if (next->target != target || batch.size() >= batch_size)
+                        {
+                            write_batch();
+                            target = next->target;
+                        }
+                        batch += next->text;
+                        delete tail;
+                        tail = next;
+                        count++;
+                    }
+                    write_batch();
+                    written.store(count, std::memory_order_release);
+
+                    if (stopping.load()) break;
+
+                    // announce sleep, then check again so a message pushed in between is not missed
+                    idle.store(true);
+                    if (tail->next.load() || stopping.load())
+                    {
+                        idle.store(false);
+                        continue;
+                    }
+                    idle.wait(true);
+                }
+            }
+
+            /**
+            * @brief give the writer a moment to write what was queued before the crash,
+            * then hand the signal to the previous handler
+            */
+            static void on_fatal_signal(int sig)
+            {
+                auto& pipeline = instance();
+                pipeline.flush(std::chrono::seconds(1));
+
+                for (size_t i = 0; i < fatal_signals.size(); ++i)
+                {
+                    if (fatal_signals[i] != sig) continue;
+                    std::signal(sig, pipeline.previous[i] == SIG_ERR ? SIG_DFL : pipeline.previous[i]);
+                }
+                std::raise(sig);
+            }
+
+        private:
+            static constexpr size_t batch_size = 64 * 1024;
+            static constexpr std::array<int, 4> fatal_signals{ SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+
+            node* tail = new node{};
+            std::atomic<node*> head{ tail };
+            std::atomic<std::uint64_t> pushed{ 0 };
+            std::atomic<std::uint64_t> written{ 0 };
+            std::atomic<bool> idle{ false };
+            std::atomic<bool> stopping{ false };
+            std::atomic<bool> running{ false };
+            std::array<void (*)(int), 4> previous{};
+            std::thread writer;
+        };
+
+        /**
+        * @brief write a report message to stdout, through the pipeline if it is running
+        */
+        inline void print(std::string text)
+        {
+            output::instance().write(stream::out, std::move(text));
+        }
+
+        /**
+        * @brief write a report message to stderr, through the pipeline if it is running
+        */
+        inline void print_error(std::string text)
+        {
+            output::instance().write(stream::err, std::move(text));
         }
 
+        /**
+        * @struct fail_values_base
+        * @brief type-erased expected and actual values of a failed check
+        */
+        struct fail_values_base
+        {
+            virtual ~fail_values_base() = default;
+            virtual void print_expected(std::ostream& out) const = 0;
+            virtual void print_actual(std::ostream& out) const = 0;
+        };
+
+        /**
+        * @struct fail_values
+        * @brief copies of the compared values, printed only when a reporter asks for them
+        */
+        template<class T1, class T2>
+        struct fail_values final : fail_values_base
+        {
+            fail_values(const T1& exp, const T2& act) : expected(exp), actual(act) {}
+
+            void print_expected(std::ostream& out) const override { out << expected; }
+            void print_actual(std::ostream& out) const override { out << actual; }
+
+            T1 expected;
+            T2 actual;
+        };
+
         /**
         * @struct test_fail
-        * @brief struct to throw when test fails
+        * @brief struct to throw when test fails. keeps the raw parts of the failure,
+        * the message is formatted only when msg() is called
         */
         struct test_fail
         {
@@ -87,26 +501,101 @@ namespace dough
 
             template<class T1, class T2>
             test_fail(
-                const std::string& message,
-                const std::string& check_type,
+                std::string_view message,
+                const char* check_type,
                 const std::source_location& location,
-                T1 expected,
-                T2 actual)
+                const T1& expected,
+                const T2& actual)
+                : check(check_type),
+                where(location),
+                text(message),
+                values(std::make_shared<const fail_values<std::decay_t<const T1&>, std::decay_t<const T2&>>>(expected, actual))
+            {
+            }
+
+            /**
+            * @brief formats fail message
+            */
+            std::string msg() const
+            {
+                if (!values) return "not initialized";
+
+                std::stringstream result;
+                result <<
+                    "[FAIL ] Failed check : " << check << '\n' <<
+                    "        File         : " << where.file_name() << '\n' <<
+                    "        Line         : " << where.line() << '\n' <<
+                    "        Expected     : " << expected() << '\n' <<
+                    "        Actual       : " << actual() << '\n' <<
+                    "        Message      : " << text << "\n\n";
+
+                return result.str();
+            }
+
+            /**
+            * @brief formats expected value
+            */
+            std::string expected() const
+            {
+                return format(&fail_values_base::print_expected);
+            }
+
+            /**
+            * @brief formats actual value
+            */
+            std::string actual() const
             {
-                msg = fail_format(message, check_type, location, expected, actual);
+                return format(&fail_values_base::print_actual);
             }
 
-            std::string msg = "not initialized";
+            const char* check = "";
+            std::source_location where;
+            std::string text;
+            std::shared_ptr<const fail_values_base> values;
+
+        private:
+            std::string format(void (fail_values_base::*print)(std::ostream&) const) const
+            {
+                if (!values) return {};
+
+                std::stringstream result;
+                result << std::boolalpha;
+                result.precision(10);
+                ((*values).*print)(result);
+                return result.str();
+            }
         };
 
         /**
         * @brief prints formatted check fail message
-        * @param values values used in the test
         */
-        template<class T>
-        void fail_print(const test_fail& fail)
+        inline void fail_print(const test_fail& fail)
+        {
+            print_error(fail.msg());
+        }
+
+        /**
+        * @brief handles a failed check: prints and throws depending on the modes.
+        * with silent and except_off nothing is built at all. kept out of line and marked cold,
+        * so a passing check compiles down to the comparison
+        */
+        template<log_mode M, except_mode E, class T1, class T2>
+        DOUGH_COLD void check_fail(
+            std::string_view message,
+            const char* check_type,
+            const std::source_location& location,
+            const T1& expected,
+            const T2& actual)
         {
-            std::cerr << "" << fail.msg;
+            if constexpr (M::value || E::value)
+            {
+                // the failure belongs to the framework, not to the allocations of the test
+                alloc_pause pause;
+                test_fail fail(message, check_type, location, expected, actual);
+
+                if constexpr (M::value) fail_print(fail);
+                if constexpr (E::value) throw fail;
+            }
         }
 
         /**
@@ -150,7 +639,7 @@ namespace dough
         * @param location location of check fail in source, don't change this unless you have a good reason to
         */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_equal(T actual, T expected, const std::string& message = std::string(),
+    inline bool check_equal(const T& actual, const T& expected, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         bool equal = false;
@@ -166,12 +655,9 @@ namespace dough
             equal = (actual == expected);
         }
 
-        if (!equal)
+        if (!equal) [[unlikely]]
         {
-            detail::test_fail fail(message, "check_equal", location, expected, actual);
-
-            if constexpr (M::value) detail::fail_print(fail);
-            if constexpr (E::value) throw fail;
+            detail::check_fail<M, E>(message, "check_equal", location, expected, actual);
         }
 
         return equal;
@@ -185,8 +671,8 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_equal(const std::initializer_list<T>&list, T value,
-        const std::string & message = std::string(),
+    inline bool check_all_equal(const std::initializer_list<T>&list, const T& value,
+        std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -203,15 +689,12 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_true(T value, const std::string & message = std::string(),
+    inline bool check_true(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!value)
+        if (!value) [[unlikely]]
         {
-            detail::test_fail fail(message, "check_true", location, true, value);
-
-            if constexpr (M::value) detail::fail_print(fail);
-            if constexpr (E::value) throw fail;
+            detail::check_fail<M, E>(message, "check_true", location, true, value);
         }
 
         return value;
@@ -224,7 +707,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_true(std::initializer_list<T> list, const std::string & message = std::string(),
+    inline bool check_all_true(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -241,15 +724,12 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_false(T value, const std::string & message = std::string(),
+    inline bool check_false(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (value)
+        if (value) [[unlikely]]
         {
-            detail::test_fail fail(message, "check_false", location, false, value);
-
-            if constexpr (M::value) detail::fail_print(fail);
-            if constexpr (E::value) throw fail;
+            detail::check_fail<M, E>(message, "check_false", location, false, value);
         }
 
         return !value;
@@ -262,7 +742,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_false(std::initializer_list<T> list, const std::string & message = std::string(),
+    inline bool check_all_false(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -279,18 +759,15 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_null(T value, const std::string & message = std::string(),
+    inline bool check_null(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (value != nullptr)
+        if (value != nullptr) [[unlikely]]
         {
-            detail::test_fail fail(message, "check_null", location, nullptr, value);
-
-            if constexpr (M::value) detail::fail_print(fail);
-            if constexpr (E::value) throw fail;
+            detail::check_fail<M, E>(message, "check_null", location, nullptr, value);
         }
 
-        return static_cast<bool>(!value);
+        return value == nullptr;
     }
 
     /**
@@ -300,7 +777,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_null(std::initializer_list<T> list, const std::string & message = std::string(),
+    inline bool check_all_null(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -317,18 +794,15 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_not_null(T value, const std::string & message = std::string(),
+    inline bool check_not_null(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (value == nullptr)
+        if (value == nullptr) [[unlikely]]
         {
-            detail::test_fail fail(message, "check_not_null", location, "not null", value);
-
-            if constexpr (M::value) detail::fail_print(fail);
-            if constexpr (E::value) throw fail;
+            detail::check_fail<M, E>(message, "check_not_null", location, "not null", value);
         }
 
-        return static_cast<bool>(value);
+        return value != nullptr;
     }
 
     /**
@@ -338,7 +812,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_not_null(std::initializer_list<T> list, const std::string & message = std::string(),
+    inline bool check_all_not_null(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -357,16 +831,13 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_near(T first, T second, T tolerance, const std::string & message = std::string(),
+    inline bool check_near(const T& first, const T& second, const T& tolerance, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         T diff = std::abs(first - second);
-        if (diff <= tolerance) return true;
-
-        detail::test_fail fail(message, "check_near", location, tolerance, diff);
+        if (diff <= tolerance) [[likely]] return true;
 
-        if constexpr (M::value) detail::fail_print(fail);
-        if constexpr (E::value) throw fail;
+        detail::check_fail<M, E>(message, "check_near", location, tolerance, diff);
 
         return false;
     }
@@ -380,8 +851,8 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, detail::except_mode E = except_on, class T>
-    inline bool check_all_near(std::initializer_list<T> list, T value, T tolerance,
-        const std::string & message = std::string(),
+    inline bool check_all_near(std::initializer_list<T> list, const T& value, const T& tolerance,
+        std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -390,13 +861,72 @@ namespace dough
         }
         return true;
     }
+
+    /**
+    * @brief use this to check that func allocates at most max blocks on the heap, e.g. 0 for a path 
+    * that must not allocate. counts the calling thread only, needs DOUGH_TRACK_ALLOCATIONS
+    * @param max allowed number of allocations
+    * @param func function to call
+    * @param message message that is printed when check fails
+    * @param location location of check fail in source, don't change this unless you have a good reason to
+    */
+    template<detail::log_mode M = silent, detail::except_mode E = except_on, class F>
+        requires std::invocable<F&>
+    inline bool check_max_allocations(std::uint64_t max, F&& func, std::string_view message = {},
+        const std::source_location& location = std::source_location::current())
+    {
+        if (!detail::alloc_tracking.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            detail::check_fail<M, E>(message.empty() ? "allocations are not tracked, define DOUGH_TRACK_ALLOCATIONS" : message,
+                "check_max_allocations", location, max, "unknown");
+            return false;
+        }
+
+        detail::alloc_scope scope;
+        std::invoke(func);
+        auto usage = scope.stop();
+        if (usage.allocations <= max) [[likely]] return true;
+
+        detail::check_fail<M, E>(message, "check_max_allocations", location, max, usage.allocations);
+
+        return false;
+    }
+
+    /**
+    * @brief use this to check that every block func allocates on the heap is freed when it returns. 
+    * counts the calling thread only, needs DOUGH_TRACK_ALLOCATIONS
+    * @param func function to call
+    * @param message message that is printed when check fails
+    * @param location location of check fail in source, don't change this unless you have a good reason to
+    */
+    template<detail::log_mode M = silent, detail::except_mode E = except_on, class F>
+        requires std::invocable<F&>
+    inline bool check_no_leaks(F&& func, std::string_view message = {},
+        const std::source_location& location = std::source_location::current())
+    {
+        if (!detail::alloc_tracking.load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            detail::check_fail<M, E>(message.empty() ? "allocations are not tracked, define DOUGH_TRACK_ALLOCATIONS" : message,
+                "check_no_leaks", location, 0, "unknown");
+            return false;
+        }
+
+        detail::alloc_scope scope;
+        std::invoke(func);
+        auto usage = scope.stop();
+        if (usage.leaked == 0) [[likely]] return true;
+
+        detail::check_fail<M, E>(message, "check_no_leaks", location, 0, usage.leaked);
+
+        return false;
+    }
        
     /************************************************************************************/
 
     /**
     * @brief callback that is called when a requirement fails. calls std::terminate() by default
     */
-    inline std::function<void()> on_require_fail = [&]() { std::terminate(); };
+    inline std::function<void()> on_require_fail = []() { std::terminate(); };
 
     /************************************************************************************/
 
@@ -408,10 +938,10 @@ namespace dough
     * @param location location of requirement fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_equal(T first, T second, const std::string& message = std::string(),
+    inline void require_equal(const T& first, const T& second, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_equal<M, except_off>(first, second, message, location))
+        if (!check_equal<M, except_off>(first, second, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -426,8 +956,8 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_equal(const std::initializer_list<T>& list, T value,
-        const std::string& message = std::string(),
+    inline void require_all_equal(const std::initializer_list<T>& list, const T& value,
+        std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -443,10 +973,10 @@ namespace dough
     * @param location location of requirement fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_true(T value, const std::string& message = std::string(),
+    inline void require_true(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_true<M, except_off>(value, message, location))
+        if (!check_true<M, except_off>(value, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -460,7 +990,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_true(std::initializer_list<T> list, const std::string& message = std::string(),
+    inline void require_all_true(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -476,10 +1006,10 @@ namespace dough
     * @param location location of requirement fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_false(T value, const std::string& message = std::string(),
+    inline void require_false(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_false<M, except_off>(value, message, location))
+        if (!check_false<M, except_off>(value, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -493,7 +1023,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_false(std::initializer_list<T> list, const std::string& message = std::string(),
+    inline void require_all_false(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -509,10 +1039,10 @@ namespace dough
     * @param location location of requirement fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_null(T value, const std::string& message = std::string(),
+    inline void require_null(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_null<M, except_off>(value, message, location))
+        if (!check_null<M, except_off>(value, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -526,7 +1056,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_null(std::initializer_list<T> list, const std::string& message = std::string(),
+    inline void require_all_null(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -542,10 +1072,10 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_not_null(T value, const std::string& message = std::string(),
+    inline void require_not_null(const T& value, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_not_null<M, except_off>(value, message, location))
+        if (!check_not_null<M, except_off>(value, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -559,7 +1089,7 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_not_null(std::initializer_list<T> list, const std::string& message = std::string(),
+    inline void require_all_not_null(std::initializer_list<T> list, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -577,10 +1107,10 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    bool require_near(T first, T second, T tolerance, const std::string& message = std::string(),
+    inline void require_near(const T& first, const T& second, const T& tolerance, std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
-        if (!check_near<M, except_off>(first, second, tolerance, message, location))
+        if (!check_near<M, except_off>(first, second, tolerance, message, location)) [[unlikely]]
         {
             if (on_require_fail) on_require_fail();
             else std::terminate();
@@ -596,8 +1126,8 @@ namespace dough
     * @param location location of check fail in source, don't change this unless you have a good reason to
     */
     template<detail::log_mode M = silent, class T>
-    inline void require_all_near(std::initializer_list<T> list, T value, T tolerance,
-        const std::string& message = std::string(),
+    inline void require_all_near(std::initializer_list<T> list, const T& value, const T& tolerance,
+        std::string_view message = {},
         const std::source_location& location = std::source_location::current())
     {
         for (const auto& val : list)
@@ -606,6 +1136,43 @@ namespace dough
         }
     }
 
+    /**
+    * @brief requires func to allocate at most max blocks on the heap. terminate on fail
+    * @param max allowed number of allocations
+    * @param func function to call
+    * @param message message that is printed when check fails
+    * @param location location of requirement fail in source, don't change this unless you have a good reason to
+    */
+    template<detail::log_mode M = silent, class F>
+        requires std::invocable<F&>
+    inline void require_max_allocations(std::uint64_t max, F&& func, std::string_view message = {},
+        const std::source_location& location = std::source_location::current())
+    {
+        if (!check_max_allocations<M, except_off>(max, std::forward<F>(func), message, location)) [[unlikely]]
+        {
+            if (on_require_fail) on_require_fail();
+            else std::terminate();
+        }
+    }
+
+    /**
+    * @brief requires func to free every block it allocates on the heap. terminate on fail
+    * @param func function to call
+    * @param message message that is printed when check fails
+    * @param location location of requirement fail in source, don't change this unless you have a good reason to
+    */
+    template<detail::log_mode M = silent, class F>
+        requires std::invocable<F&>
+    inline void require_no_leaks(F&& func, std::string_view message = {},
+        const std::source_location& location = std::source_location::current())
+    {
+        if (!check_no_leaks<M, except_off>(std::forward<F>(func), message, location)) [[unlikely]]
+        {
+            if (on_require_fail) on_require_fail();
+            else std::terminate();
+        }
+    }
+
     /************************************************************************************/
 
     namespace detail
@@ -613,11 +1180,11 @@ namespace dough
         /**
         * @brief array of reserved characters
         */
-        const std::array<char, 2> reserved_chars{ '!', ',' };
+        constexpr std::array<char, 2> reserved_chars{ '!', ',' };
         /**
         * @brief char with which reserved chars are replaced
         */
-        const char replace_char = '_';
+        constexpr char replace_char = '_';
 
         /**
         * @brief replaces reserved characters from string
@@ -634,953 +1201,7757 @@ namespace dough
         }
 
         /**
-        * @brief find unordered set intersection
+        * @brief 64-bit FNV-1a, stable across platforms and runs
         */
-        std::unordered_set<std::string> uset_intersection(
-            const std::unordered_set<std::string>& first,
-            const std::unordered_set<std::string>& second)
+        constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = 14695981039346656037ull)
         {
-            std::unordered_set<std::string> intersection;
-            for (const auto& elem : first)
+            for (char c : str)
             {
-                if (second.contains(elem)) intersection.insert(elem);
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
             }
-            return intersection;
+            return hash;
         }
 
         /**
-        * @brief checks if sets have at least one common element
+        * @brief stable hash of 'suite::test', used as test id. the suite name is hashed 
+        * as registered, with reserved characters replaced
         */
-        bool uset_have_common(
-            const std::unordered_set<std::string>& first,
-            const std::unordered_set<std::string>& second
-        )
+        constexpr std::uint64_t test_hash(std::string_view suite_name, std::string_view test_name)
         {
-            const auto& [smallest, largest] = (first.size() < second.size() ?
-                std::tie(first, second) : std::tie(second, first));
-
-            for (const auto& elem : smallest)
+            std::uint64_t hash = 14695981039346656037ull;
+            for (char c : suite_name)
             {
-                if (largest.contains(elem)) return true;
+                if (std::find(reserved_chars.begin(), reserved_chars.end(), c) != reserved_chars.end()) c = replace_char;
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
             }
-            return false;
+            return fnv1a(test_name, fnv1a("::", hash));
         }
 
         /**
-        * @brief insert arbitrary number of values into uset
+        * @brief format a test id as 16 hex digits
         */
-        template<class T, class... Args>
-        void uset_insert(std::unordered_set<T>& set, Args... args) 
+        inline std::string id_format(std::uint64_t id)
         {
-            (set.insert(args), ...);
+            return std::format("{:016x}", id);
         }
-    }
 
-    /**
-    * @struct include_tags
-    * @brief structure that holds tags to include
-    */
-    struct include_tags
-    {
-        std::unordered_set<std::string> set;
-    };
+        /**
+        * @brief parse a test id written by id_format, '0x' prefix allowed
+        */
+        inline std::optional<std::uint64_t> id_parse(std::string_view str)
+        {
+            if (str.starts_with("0x") || str.starts_with("0X")) str.remove_prefix(2);
+            std::uint64_t id = 0;
+            auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), id, 16);
+            if (str.empty() || ec != std::errc() || end != str.data() + str.size()) return std::nullopt;
+            return id;
+        }
 
-    /**
-    * @struct exclude_tags
-    * @brief structure that holds tags to include
-    */
-    struct exclude_tags
-    {
-        std::unordered_set<std::string> set;
-    };
+        /**
+        * @struct string_hash
+        * @brief transparent hash, so maps keyed by std::string can be searched with a string_view
+        */
+        struct string_hash
+        {
+            using is_transparent = void;
 
-    /**
-    * @brief helper function for including tags in filter
-    */
-    template<typename First, typename... Rest>
-        requires
-    (std::convertible_to<First, std::string> &&
-        (std::convertible_to<Rest, std::string> && ...))
-        include_tags inc(const First& first, const Rest&... rest)
-    {
-        include_tags tags;
-        detail::uset_insert(tags.set, first, rest...);
-        return tags;
-    }
-    include_tags inc() { return include_tags(); }
+            size_t operator()(std::string_view str) const noexcept
+            {
+                return std::hash<std::string_view>{}(str);
+            }
+        };
 
-    /**
-    * @brief helper function for excluding tags in filter
-    */
-    template<typename First, typename... Rest>
-        requires
-    (std::convertible_to<First, std::string> &&
-        (std::convertible_to<Rest, std::string> && ...))
-        exclude_tags exc(const First& first, const Rest&... rest)
-    {
-        exclude_tags tags;
-        detail::uset_insert(tags.set, first, rest...);
-        return tags;
-    }
-    exclude_tags exc() { return exclude_tags(); }
+        /**
+        * @class tag_dictionary
+        * @brief interns tag names to small ids. process-wide, because tests are tagged 
+        * before they are registered. names are never removed, so ids and views stay valid
+        */
+        class tag_dictionary
+        {
+        public:
+            static tag_dictionary& instance()
+            {
+                static tag_dictionary dictionary;
+                return dictionary;
+            }
 
-    class suite;
-    class test;
+            /**
+            * @brief get id of a tag, adding it if it is new
+            */
+            std::uint32_t intern(std::string_view tag)
+            {
+                std::lock_guard lock(mtx);
+                if (auto it = ids.find(tag); it != ids.end()) return it->second;
 
-    /**
-    * @class test
-    * @brief represents a single test
-    */
-    class test
-    {
-        friend class suite;
+                auto id = static_cast<std::uint32_t>(names.size());
+                ids.emplace(names.emplace_back(tag), id);
+                return id;
+            }
 
-    public:
-        test(std::string name) noexcept : test_name(std::move(name)) {}
-        test(const test& src) = default;
+            /**
+            * @brief get id of a known tag, does not add unknown ones
+            */
+            std::optional<std::uint32_t> find(std::string_view tag) const
+            {
+                std::lock_guard lock(mtx);
+                if (auto it = ids.find(tag); it != ids.end()) return it->second;
+                return std::nullopt;
+            }
 
-        /**
-        * @brief set test function
-        */
-        test& func(std::function<void()> test_func) noexcept
-        {
-            if (test_func) function = std::move(test_func);
-            return *this;
-        }
+            /**
+            * @brief get tag name of an id
+            */
+            std::string_view name(std::uint32_t id) const
+            {
+                std::lock_guard lock(mtx);
+                return names[id];
+            }
+
+        private:
+            tag_dictionary() = default;
+
+        private:
+            mutable std::mutex mtx;
+            std::deque<std::string> names;                              // deque keeps the viewed strings in place
+            std::unordered_map<std::string_view, std::uint32_t> ids;
+        };
 
         /**
-        * @brief add test tags
+        * @class tag_set
+        * @brief set of interned tag ids as a bitset. the first 64 tags are stored inline,
+        * so most sets never allocate and filtering is a few word operations
         */
-        template<typename First, typename... Rest>
-            requires 
-        (std::convertible_to<First, std::string> &&
-        (std::convertible_to<Rest, std::string> && ...))
-            test& tags(First&& first, Rest&&... rest) noexcept
+        class tag_set
         {
-            detail::uset_insert(tag_set, detail::sanitize_tag(first), detail::sanitize_tag(rest)...);
-            return *this;
-        }
+        public:
+            void insert(std::uint32_t id)
+            {
+                if (id < 64)
+                {
+                    first |= std::uint64_t(1) << id;
+                    return;
+                }
+                size_t word = id / 64 - 1;
+                if (rest.size() <= word) rest.resize(word + 1, 0);
+                rest[word] |= std::uint64_t(1) << (id % 64);
+            }
+
+            bool contains(std::uint32_t id) const noexcept
+            {
+                if (id < 64) return first & (std::uint64_t(1) << id);
+                size_t word = id / 64 - 1;
+                return word < rest.size() && (rest[word] & (std::uint64_t(1) << (id % 64)));
+            }
+
+            /**
+            * @brief checks if sets have at least one common tag
+            */
+            bool intersects(const tag_set& other) const noexcept
+            {
+                if (first & other.first) return true;
+                size_t words = std::min(rest.size(), other.rest.size());
+                for (size_t i = 0; i < words; ++i)
+                {
+                    if (rest[i] & other.rest[i]) return true;
+                }
+                return false;
+            }
+
+            tag_set& operator|=(const tag_set& other)
+            {
+                first |= other.first;
+                if (rest.size() < other.rest.size()) rest.resize(other.rest.size(), 0);
+                for (size_t i = 0; i < other.rest.size(); ++i) rest[i] |= other.rest[i];
+                return *this;
+            }
+
+            bool empty() const noexcept
+            {
+                return first == 0 && std::all_of(rest.begin(), rest.end(), [](std::uint64_t w) { return w == 0; });
+            }
+
+            /**
+            * @brief call func with every id in the set, in ascending order
+            */
+            template<class F>
+            void for_each(F&& func) const
+            {
+                auto word_each = [&](std::uint64_t word, std::uint32_t base)
+                    {
+                        while (word)
+                        {
+                            func(base + static_cast<std::uint32_t>(std::countr_zero(word)));
+                            word &= word - 1;
+                        }
+                    };
+                word_each(first, 0);
+                for (size_t i = 0; i < rest.size(); ++i) word_each(rest[i], static_cast<std::uint32_t>((i + 1) * 64));
+            }
+
+        private:
+            std::uint64_t first = 0;
+            std::vector<std::uint64_t> rest;
+        };
 
         /**
-        * @brief get tag set
+        * @brief intern tags into a set
         */
-        const std::unordered_set<std::string>& tags() const noexcept
+        template<class... Args>
+        void tags_insert(tag_set& set, Args&&... tags)
         {
-            return tag_set;
+            auto& dictionary = tag_dictionary::instance();
+            (set.insert(dictionary.intern(sanitize_tag(std::forward<Args>(tags)))), ...);
         }
 
         /**
-        * @brief set name
+        * @brief tag names of a set, sorted by name so the output does not depend on interning order
         */
-        test& name(std::string new_name) noexcept
+        inline std::vector<std::string_view> tags_names(const tag_set& set)
         {
-            test_name = std::move(new_name);
-            return *this;
+            std::vector<std::string_view> names;
+            auto& dictionary = tag_dictionary::instance();
+            set.for_each([&](std::uint32_t id) { names.push_back(dictionary.name(id)); });
+            std::sort(names.begin(), names.end());
+            return names;
         }
 
         /**
-        * @brief get name
+        * @brief insert arbitrary number of values into uset
         */
-        const std::string& name() const noexcept
+        template<class T, class... Args>
+        void uset_insert(std::unordered_set<T>& set, Args... args) 
         {
-            return test_name;
+            (set.insert(args), ...);
         }
 
+        template<class T>
+        struct is_std_function : std::false_type {};
+
+        template<class Signature>
+        struct is_std_function<std::function<Signature>> : std::true_type {};
+
+        template<class Signature, size_t Size = 48>
+        class small_function;
+
         /**
-        * @brief run the test
+        * @class small_function
+        * @brief copyable callable like std::function, but callables of up to Size bytes 
+        * (a lambda capturing a few references or values) are stored inline instead of 
+        * on the heap. larger ones still allocate
         */
-        bool run()
+        template<class R, class... Args, size_t Size>
+        class small_function<R(Args...), Size>
         {
-            if (function)
+        public:
+            small_function() noexcept = default;
+            small_function(std::nullptr_t) noexcept {}
+
+            template<class F>
+                requires (!std::is_same_v<std::remove_cvref_t<F>, small_function> &&
+                    std::is_copy_constructible_v<std::decay_t<F>> &&
+                    std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+            small_function(F&& func)
             {
-                try
+                using D = std::decay_t<F>;
+                if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D> || is_std_function<D>::value)
                 {
-                    start_print();
-                    function();
-                    result_print(true);
-                    return true;
+                    if (!func) return;
                 }
-                catch (const detail::test_fail& f)
+
+                if constexpr (stored_inline<D>)
                 {
-                    result_print(false, f);
-                    return false;
+                    ::new (static_cast<void*>(buffer)) D(std::forward<F>(func));
+                    ops = &inline_ops<D>;
                 }
-                catch (const std::exception& e)
+                else
                 {
-                    error_print(e.what());
-                    return false;
+                    *reinterpret_cast<D**>(buffer) = new D(std::forward<F>(func));
+                    ops = &heap_ops<D>;
                 }
-                catch (...)
+            }
+
+            small_function(const small_function& src)
+            {
+                if (src.ops) src.ops->copy(src.buffer, buffer);
+                ops = src.ops;
+            }
+
+            small_function(small_function&& src) noexcept
+            {
+                if (src.ops) src.ops->move(src.buffer, buffer);
+                ops = std::exchange(src.ops, nullptr);
+            }
+
+            small_function& operator=(const small_function& src)
+            {
+                if (this != &src) *this = small_function(src);
+                return *this;
+            }
+
+            small_function& operator=(small_function&& src) noexcept
+            {
+                if (this == &src) return *this;
+                reset();
+                if (src.ops) src.ops->move(src.buffer, buffer);
+                ops = std::exchange(src.ops, nullptr);
+                return *this;
+            }
+
+            ~small_function()
+            {
+                reset();
+            }
+
+            R operator()(Args... args) const
+            {
+                return ops->invoke(buffer, std::forward<Args>(args)...);
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return ops != nullptr;
+            }
+
+        private:
+            struct operations
+            {
+                R (*invoke)(void* target, Args&&... args);
+                void (*copy)(const void* src, void* dst);
+                void (*move)(void* src, void* dst) noexcept;    // leaves src empty
+                void (*destroy)(void* target) noexcept;
+            };
+
+            template<class D>
+            static constexpr bool stored_inline = sizeof(D) <= Size &&
+                alignof(D) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<D>;
+
+            template<class D>
+            static constexpr operations inline_ops{
+                [](void* target, Args&&... args) -> R { return std::invoke(*std::launder(static_cast<D*>(target)), std::forward<Args>(args)...); },
+                [](const void* src, void* dst) { ::new (dst) D(*std::launder(static_cast<const D*>(src))); },
+                [](void* src, void* dst) noexcept
                 {
-                    error_print();
-                    return false;
-                }
+                    D* from = std::launder(static_cast<D*>(src));
+                    ::new (dst) D(std::move(*from));
+                    from->~D();
+                },
+                [](void* target) noexcept { std::launder(static_cast<D*>(target))->~D(); }
+            };
+
+            template<class D>
+            static constexpr operations heap_ops{
+                [](void* target, Args&&... args) -> R { return std::invoke(**static_cast<D**>(target), std::forward<Args>(args)...); },
+                [](const void* src, void* dst) { *static_cast<D**>(dst) = new D(**static_cast<D* const*>(src)); },
+                [](void* src, void* dst) noexcept { *static_cast<D**>(dst) = *static_cast<D**>(src); },
+                [](void* target) noexcept { delete *static_cast<D**>(target); }
+            };
+
+            void reset() noexcept
+            {
+                if (ops) ops->destroy(buffer);
+                ops = nullptr;
             }
-            return false;
-        }
 
-    private:
-        /**
-        * @brief set owner suite
-        */
-        void owner(const std::string& name) noexcept
-        {
-            owner_name = name;
-        }
+        private:
+            alignas(std::max_align_t) mutable std::byte buffer[Size < sizeof(void*) ? sizeof(void*) : Size];
+            const operations* ops = nullptr;
+        };
 
         /**
-        * @brief prints test run start message
+        * @class block_list
+        * @brief append-only sequence stored in fixed blocks of BlockSize elements. elements 
+        * never move once added, so growing does not copy them and pointers to them stay 
+        * valid, and iterating walks contiguous memory block by block
         */
-        void start_print() const noexcept
+        template<class T, size_t BlockSize = 64>
+        class block_list
         {
-            std::stringstream sstr;
-            sstr << "[RUN  ] " << owner_name << " :: " << test_name << '\n';
-            std::cout << sstr.str();
-        }
+            struct block
+            {
+                alignas(T) std::byte storage[sizeof(T) * BlockSize];
 
-        /**
-        * @brief print test result
-        */
-        void result_print(bool success, detail::test_fail fail = {}) const noexcept
-        {
-            std::stringstream sstr;
-            if (success)
-                sstr << "[PASS ] " << owner_name << " :: " << test_name << '\n';
-            else
-                sstr << fail.msg;
+                T* at(size_t index) noexcept
+                {
+                    return std::launder(reinterpret_cast<T*>(storage) + index);
+                }
+            };
 
-            std::cout << sstr.str();
-        }
+        public:
+            template<bool Const>
+            class basic_iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = std::conditional_t<Const, const T*, T*>;
+                using reference = std::conditional_t<Const, const T&, T&>;
+
+                basic_iterator() noexcept = default;
+                basic_iterator(std::conditional_t<Const, const block_list*, block_list*> owner, size_t index) noexcept
+                    : list(owner), pos(index) {}
+
+                reference operator*() const noexcept { return (*list)[pos]; }
+                pointer operator->() const noexcept { return &(*list)[pos]; }
+                basic_iterator& operator++() noexcept
+                {
+                    ++pos;
+                    return *this;
+                }
+                basic_iterator operator++(int) noexcept
+                {
+                    auto copy = *this;
+                    ++pos;
+                    return copy;
+                }
+                bool operator==(const basic_iterator& other) const noexcept { return pos == other.pos; }
 
-        /**
-        * @brief print error if a non-test_fail exception if thrown
-        */
-        void error_print(const std::string& msg = std::string()) const noexcept
-        {
-            std::stringstream sstr;
-            sstr << "[ERROR] Test '" << test_name << "' threw an exception: " <<
-                (msg.empty() ? "unknown exception" : msg) << '\n';
-            std::cerr << sstr.str();
-        }
+            private:
+                std::conditional_t<Const, const block_list*, block_list*> list = nullptr;
+                size_t pos = 0;
+            };
 
-    private:
-        std::unordered_set<std::string> tag_set;
-        std::function<void()> function = nullptr;
-        std::string test_name;
-        std::string owner_name;
-    };
+            using iterator = basic_iterator<false>;
+            using const_iterator = basic_iterator<true>;
 
-    /**
-    * @class suite
-    * @brief test suite class
-    */
-    class suite
-    {
-        friend test;
+            block_list() = default;
 
-    public:
-        /**
-        * @struct stats
-        * @brief holds stats for a suite run
-        */
-        struct stats
-        {
-            std::vector<std::string> failed;
-            int run = 0,
-                pass = 0,
-                fail = 0;
-        };
+            block_list(const block_list& src)
+            {
+                for (const auto& elem : src) emplace_back(elem);
+            }
 
-    public:
-        suite(std::string name) noexcept : suite_name(std::move(name)) {}
+            block_list(block_list&& src) noexcept
+                : blocks(std::move(src.blocks)), count(std::exchange(src.count, 0)) {}
+
+            block_list& operator=(const block_list& src)
+            {
+                if (this != &src) *this = block_list(src);
+                return *this;
+            }
+
+            block_list& operator=(block_list&& src) noexcept
+            {
+                if (this == &src) return *this;
+                clear();
+                blocks = std::move(src.blocks);
+                count = std::exchange(src.count, 0);
+                return *this;
+            }
+
+            ~block_list()
+            {
+                clear();
+            }
+
+            /**
+            * @brief construct an element at the end, allocates only when a block is full
+            */
+            template<class... A>
+            T& emplace_back(A&&... args)
+            {
+                if (count / BlockSize == blocks.size()) blocks.emplace_back(new block);
+                T* elem = ::new (static_cast<void*>(blocks[count / BlockSize]->at(count % BlockSize))) T(std::forward<A>(args)...);
+                ++count;
+                return *elem;
+            }
+
+            /**
+            * @brief destroy all elements, the blocks are kept for reuse
+            */
+            void clear() noexcept
+            {
+                for (size_t i = count; i > 0; --i) (*this)[i - 1].~T();
+                count = 0;
+            }
+
+            T& operator[](size_t index) noexcept { return *blocks[index / BlockSize]->at(index % BlockSize); }
+            const T& operator[](size_t index) const noexcept { return *blocks[index / BlockSize]->at(index % BlockSize); }
+
+            size_t size() const noexcept { return count; }
+            bool empty() const noexcept { return count == 0; }
+
+            iterator begin() noexcept { return { this, 0 }; }
+            iterator end() noexcept { return { this, count }; }
+            const_iterator begin() const noexcept { return { this, 0 }; }
+            const_iterator end() const noexcept { return { this, count }; }
+
+        private:
+            std::vector<std::unique_ptr<block>> blocks;
+            size_t count = 0;
+        };
 
         /**
-        * @brief add setup function that will run before each test
+        * @brief cpu time consumed by the calling thread
         */
-        suite& setup(std::function<void()> setup_func)
+        inline std::chrono::nanoseconds thread_cpu_time() noexcept
         {
-            if (setup_func) setup_function = std::move(setup_func);
-            return *this;
+#if DOUGH_POSIX
+            timespec ts{};
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#elif defined(_WIN32)
+            FILETIME creation, exit, kernel, user;
+            if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return {};
+            auto ticks = [](const FILETIME& ft) { return (static_cast<long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+            return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+#else
+            return std::chrono::nanoseconds(static_cast<long long>(std::clock() * (1e9 / CLOCKS_PER_SEC)));
+#endif
         }
 
         /**
-        * @brief add teardown function that will run after each test
+        * @brief time elapsed since start
         */
-        suite& teardown(std::function<void()> teardown_func)
+        inline std::chrono::nanoseconds since(std::chrono::steady_clock::time_point start) noexcept
         {
-            if (teardown_func) teardown_function = std::move(teardown_func);
-            return *this;
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
         }
 
         /**
-        * @brief add suite tags. these are inherited by all test in a suite
+        * @brief format duration with a readable unit, e.g. '1.25 ms'
         */
-        template<typename First, typename... Rest>
-            requires 
-        (std::convertible_to<First, std::string> &&
-        (std::convertible_to<Rest, std::string> && ...))
-            suite& tags(First&& first, Rest&&... rest) noexcept
+        inline std::string duration_format(std::chrono::nanoseconds duration)
         {
-            detail::uset_insert(tag_set, detail::sanitize_tag(first), detail::sanitize_tag(rest)...);
-            for (auto& test : test_list) test.tags(first, rest...);
-            return *this;
+            double ns = static_cast<double>(duration.count());
+            if (ns < 1e3) return std::format("{} ns", duration.count());
+            if (ns < 1e6) return std::format("{:.2f} us", ns / 1e3);
+            if (ns < 1e9) return std::format("{:.2f} ms", ns / 1e6);
+            return std::format("{:.2f} s", ns / 1e9);
         }
 
         /**
-        * @brief get tag set
+        * @brief format fractional nanoseconds, e.g. '1.25 ns' or '3.10 us'
         */
-        const std::unordered_set<std::string>& tags() const noexcept
+        inline std::string nanoseconds_format(double ns)
         {
-            return tag_set;
+            if (ns < 1e3) return std::format("{:.2f} ns", ns);
+            return duration_format(std::chrono::nanoseconds(std::llround(ns)));
         }
 
         /**
-        * @brief register test
+        * @brief format a byte count with a readable unit, e.g. '1.25 KB'
         */
-        suite& add(test new_test) noexcept
+        inline std::string bytes_format(std::uint64_t bytes)
         {
-            auto& ntst = test_list.emplace_back(std::move(new_test));
-            ntst.owner(suite_name);
-
-            // inherit suite tags
-            for (const auto& tag : tag_set)
-            {
-                ntst.tags(tag);
-            }
-
-            return *this;
+            double b = static_cast<double>(bytes);
+            if (b < 1024) return std::format("{} B", bytes);
+            if (b < 1024.0 * 1024) return std::format("{:.2f} KB", b / 1024);
+            if (b < 1024.0 * 1024 * 1024) return std::format("{:.2f} MB", b / (1024.0 * 1024));
+            return std::format("{:.2f} GB", b / (1024.0 * 1024 * 1024));
         }
 
         /**
-        * @brief set name
+        * @brief format heap usage for a report line, e.g. '12 allocations (1.25 KB, peak 512 B), 1 leaked'
         */
-        suite& name(std::string new_name) noexcept
+        inline std::string alloc_format(const alloc_usage& usage)
         {
-            suite_name = std::move(new_name);
-            return *this;
+            auto text = std::format("{} allocations ({}, peak {})", usage.allocations, bytes_format(usage.bytes), bytes_format(usage.peak));
+            if (usage.leaked > 0) text += std::format(", {} leaked", usage.leaked);
+            return text;
         }
 
         /**
-        * @brief get name
+        * @struct perf_usage
+        * @brief hardware counters and resource usage of the thread running a test, see options::perf. 
+        * counters are scaled when the kernel had to multiplex them
         */
-        const std::string& name() const noexcept
+        struct perf_usage
         {
-            return suite_name;
-        }
+            enum event : unsigned { cycles, instructions, branch_misses, l1d_misses, llc_misses, event_count };
+
+            std::uint32_t events = 0;                       // bit per event that was counted
+            std::array<std::uint64_t, event_count> counts{};
+            bool resources = false;                         // rusage fields are set
+            std::chrono::nanoseconds user{};                // cpu time in user mode
+            std::chrono::nanoseconds system{};              // cpu time in the kernel
+            std::uint64_t voluntary_switches = 0;           // context switches while waiting, e.g. for io or a lock
+            std::uint64_t involuntary_switches = 0;         // context switches by preemption
+            std::uint64_t minor_faults = 0;                 // page faults served without io
+            std::uint64_t major_faults = 0;                 // page faults that needed io
+
+            bool counted(event e) const noexcept
+            {
+                return (events >> e) & 1;
+            }
 
+            /**
+            * @brief instructions per cycle, 0 if either was not counted
+            */
+            double ipc() const noexcept
+            {
+                if (!counted(cycles) || !counted(instructions) || counts[cycles] == 0) return 0;
+                return static_cast<double>(counts[instructions]) / static_cast<double>(counts[cycles]);
+            }
+
+            perf_usage& operator+=(const perf_usage& other) noexcept
+            {
+                events |= other.events;
+                for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+                resources |= other.resources;
+                user += other.user;
+                system += other.system;
+                voluntary_switches += other.voluntary_switches;
+                involuntary_switches += other.involuntary_switches;
+                minor_faults += other.minor_faults;
+                major_faults += other.major_faults;
+                return *this;
+            }
+        };
+
+#if defined(__linux__)
         /**
-        * @brief get list of tests
+        * @class perf_group
+        * @brief perf_event_open counter group of the calling thread, user space only. opened once per
+        * thread and left running, readings are taken with a single read of the group
         */
-        const std::vector<test>& tests() const noexcept
+        class perf_group
         {
-            return test_list;
+        public:
+            /**
+            * @struct reading
+            * @brief raw counter values with the time the group was enabled and actually running
+            */
+            struct reading
+            {
+                std::array<std::uint64_t, perf_usage::event_count> values{};
+                std::uint64_t enabled = 0;
+                std::uint64_t running = 0;
+            };
+
+            /**
+            * @brief group of the calling thread. a forked worker opens its own, the inherited one counts the parent
+            */
+            static perf_group& thread()
+            {
+                thread_local perf_group group;
+                if (group.owner != ::getpid()) group.open();
+                return group;
+            }
+
+            ~perf_group()
+            {
+                close();
+            }
+
+            perf_group(const perf_group&) = delete;
+            perf_group& operator=(const perf_group&) = delete;
+
+            /**
+            * @brief bit per event that could be opened, 0 if counters are not available
+            */
+            std::uint32_t events() const noexcept
+            {
+                return opened;
+            }
+
+            /**
+            * @brief errno of the failed open of the first event, 0 if it worked
+            */
+            int error() const noexcept
+            {
+                return open_error;
+            }
+
+            bool read(reading& out) const noexcept
+            {
+                if (opened == 0) return false;
+
+                // nr, time enabled, time running, then one value per opened event in opening order
+                std::array<std::uint64_t, 3 + perf_usage::event_count> buffer{};
+                if (::read(fds[0], buffer.data(), sizeof(buffer)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) return false;
+
+                out.enabled = buffer[1];
+                out.running = buffer[2];
+                size_t slot = 3;
+                for (unsigned e = 0; e < perf_usage::event_count; ++e)
+                {
+                    out.values[e] = (opened >> e) & 1 ? buffer[slot++] : 0;
+                }
+                return true;
+            }
+
+        private:
+            perf_group() = default;
+
+            void open() noexcept
+            {
+                close();
+                owner = ::getpid();
+
+                constexpr std::array<std::pair<std::uint32_t, std::uint64_t>, perf_usage::event_count> configs{ {
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+                    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },     // last level cache on most cpus
+                } };
+
+                for (unsigned e = 0; e < configs.size(); ++e)
+                {
+                    perf_event_attr attr{};
+                    attr.size = sizeof(attr);
+                    attr.type = configs[e].first;
+                    attr.config = configs[e].second;
+                    attr.exclude_kernel = 1;    // allowed with perf_event_paranoid up to 2
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                    int leader = e == 0 ? -1 : fds[0];
+                    int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+                    if (fd < 0)
+                    {
+                        // without the leader there is no group, other events are optional
+                        if (e == 0)
+                        {
+                            open_error = errno;
+                            return;
+                        }
+                        continue;
+                    }
+                    fds[e] = fd;
+                    opened |= 1u << e;
+                }
+            }
+
+            void close() noexcept
+            {
+                for (auto& fd : fds)
+                {
+                    if (fd >= 0) ::close(fd);
+                    fd = -1;
+                }
+                opened = 0;
+                open_error = 0;
+            }
+
+        private:
+            std::array<int, perf_usage::event_count> fds{ -1, -1, -1, -1, -1 };
+            std::uint32_t opened = 0;
+            int open_error = 0;
+            pid_t owner = -1;
+        };
+#endif
+
+        /**
+        * @class perf_scope
+        * @brief measures hardware counters and rusage of the calling thread from construction to stop(). 
+        * falls back to rusage alone where counters are not available, measures nothing off linux
+        */
+        class perf_scope
+        {
+        public:
+            explicit perf_scope(bool enabled) noexcept
+                : enabled(enabled)
+            {
+#if defined(__linux__)
+                if (!enabled) return;
+                has_counters = perf_group::thread().read(counters);
+                has_resources = ::getrusage(RUSAGE_THREAD, &resources) == 0;
+#endif
+            }
+
+            perf_usage stop() noexcept
+            {
+                perf_usage usage;
+#if defined(__linux__)
+                if (!enabled) return usage;
+
+                perf_group::reading now;
+                if (has_counters && perf_group::thread().read(now))
+                {
+                    // scale up counts of a multiplexed group by how long it actually ran
+                    std::uint64_t enabled_time = now.enabled - counters.enabled,
+                        running_time = now.running - counters.running;
+                    double scale = running_time > 0 && running_time < enabled_time ?
+                        static_cast<double>(enabled_time) / static_cast<double>(running_time) : 1.0;
+
+                    usage.events = perf_group::thread().events();
+                    for (size_t e = 0; e < usage.counts.size(); ++e)
+                    {
+                        usage.counts[e] = static_cast<std::uint64_t>(static_cast<double>(now.values[e] - counters.values[e]) * scale);
+                    }
+                }
+
+                rusage after{};
+                if (has_resources && ::getrusage(RUSAGE_THREAD, &after) == 0)
+                {
+                    auto time = [](const timeval& tv) { return std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec); };
+                    usage.resources = true;
+                    usage.user = time(after.ru_utime) - time(resources.ru_utime);
+                    usage.system = time(after.ru_stime) - time(resources.ru_stime);
+                    usage.voluntary_switches = static_cast<std::uint64_t>(after.ru_nvcsw - resources.ru_nvcsw);
+                    usage.involuntary_switches = static_cast<std::uint64_t>(after.ru_nivcsw - resources.ru_nivcsw);
+                    usage.minor_faults = static_cast<std::uint64_t>(after.ru_minflt - resources.ru_minflt);
+                    usage.major_faults = static_cast<std::uint64_t>(after.ru_majflt - resources.ru_majflt);
+                }
+#endif
+                return usage;
+            }
+
+        private:
+            bool enabled;
+#if defined(__linux__)
+            bool has_counters = false;
+            bool has_resources = false;
+            perf_group::reading counters;
+            rusage resources{};
+#endif
+        };
+
+        /**
+        * @brief tell what options::perf can measure here, before the run starts
+        */
+        inline void perf_probe()
+        {
+#if defined(__linux__)
+            const auto& group = perf_group::thread();
+            if (group.events() == 0)
+            {
+                print_error(std::format("[DOUGH] Hardware counters are not available ({}), measuring rusage only\n", std::strerror(group.error())));
+            }
+#else
+            print_error("[DOUGH] Hardware counters and rusage are only measured on linux\n");
+#endif
         }
 
         /**
-        * @brief run all tests in a suite
+        * @brief format a large count with a metric suffix, e.g. '1.25M'
         */
-        stats run()
+        inline std::string count_format(double count)
         {
-            start_print();
-            stats st;
-            for (auto& test : test_list)
+            if (count < 1e3) return std::format("{:.0f}", count);
+            if (count < 1e6) return std::format("{:.2f}K", count / 1e3);
+            if (count < 1e9) return std::format("{:.2f}M", count / 1e6);
+            return std::format("{:.2f}G", count / 1e9);
+        }
+
+        /**
+        * @brief format hardware counters for a summary line, empty if none were counted
+        */
+        inline std::string counters_format(const perf_usage& usage)
+        {
+            std::string text;
+            auto add = [&](const std::string& part)
+                {
+                    text += text.empty() ? part : ", " + part;
+                };
+            auto count = [&](perf_usage::event e) { return static_cast<double>(usage.counts[e]); };
+
+            if (usage.counted(perf_usage::cycles)) add(count_format(count(perf_usage::cycles)) + " cycles");
+            if (usage.ipc() > 0) add(std::format("IPC {:.2f}", usage.ipc()));
+            if (usage.counted(perf_usage::branch_misses)) add(count_format(count(perf_usage::branch_misses)) + " branch misses");
+            if (usage.counted(perf_usage::l1d_misses)) add(count_format(count(perf_usage::l1d_misses)) + " L1d misses");
+            if (usage.counted(perf_usage::llc_misses)) add(count_format(count(perf_usage::llc_misses)) + " LLC misses");
+            return text;
+        }
+
+        /**
+        * @brief format rusage for a summary line, empty if it was not measured
+        */
+        inline std::string resources_format(const perf_usage& usage)
+        {
+            if (!usage.resources) return {};
+            return std::format("user {}, system {}, {} context switches ({} involuntary), {} page faults ({} major)",
+                duration_format(usage.user), duration_format(usage.system),
+                usage.voluntary_switches + usage.involuntary_switches, usage.involuntary_switches,
+                usage.minor_faults + usage.major_faults, usage.major_faults);
+        }
+
+        /**
+        * @brief sink for do_not_optimize on compilers without inline asm
+        */
+        inline const volatile void* volatile bench_sink = nullptr;
+
+        /**
+        * @struct outcome
+        * @brief result of one test run. trivially copyable, so isolated workers can send it over a pipe as is
+        */
+        struct outcome
+        {
+            bool passed = false;
+            std::chrono::nanoseconds wall{};        // test function, wall clock
+            std::chrono::nanoseconds cpu{};         // test function, cpu time of the running thread
+            std::chrono::nanoseconds setup{};       // suite setup before the test
+            std::chrono::nanoseconds teardown{};    // suite teardown after the test
+            std::chrono::nanoseconds fixture_setup{};   // setup_once and fixture of the suite, made before this test if it was the first
+            std::uint64_t cases = 0;                // cases run by a parameterized test
+            std::uint64_t failed_cases = 0;         // cases of them that failed
+            bool timed_out = false;                 // the test ran over its timeout
+            alloc_usage memory;                     // heap usage of the test function, if allocations are tracked
+            perf_usage perf;                        // counters and rusage of the test function, if options::perf is on
+
+            /**
+            * @brief full time the test took, setup and teardown included
+            */
+            std::chrono::nanoseconds elapsed() const noexcept
             {
-                if (setup_function) setup_function();
-                
-                if (test.run()) st.pass++;
-                else
+                return setup + wall + teardown;
+            }
+        };
+    }
+
+    /**
+    * @struct include_tags
+    * @brief structure that holds tags to include
+    */
+    struct include_tags
+    {
+        std::unordered_set<std::string> set;
+    };
+
+    /**
+    * @struct exclude_tags
+    * @brief structure that holds tags to include
+    */
+    struct exclude_tags
+    {
+        std::unordered_set<std::string> set;
+    };
+
+    /**
+    * @brief helper function for including tags in filter
+    */
+    template<typename First, typename... Rest>
+        requires
+    (std::convertible_to<First, std::string> &&
+        (std::convertible_to<Rest, std::string> && ...))
+        include_tags inc(const First& first, const Rest&... rest)
+    {
+        include_tags tags;
+        detail::uset_insert(tags.set, first, rest...);
+        return tags;
+    }
+    inline include_tags inc() { return include_tags(); }
+
+    /**
+    * @brief helper function for excluding tags in filter
+    */
+    template<typename First, typename... Rest>
+        requires
+    (std::convertible_to<First, std::string> &&
+        (std::convertible_to<Rest, std::string> && ...))
+        exclude_tags exc(const First& first, const Rest&... rest)
+    {
+        exclude_tags tags;
+        detail::uset_insert(tags.set, first, rest...);
+        return tags;
+    }
+    inline exclude_tags exc() { return exclude_tags(); }
+
+    namespace detail
+    {
+        /**
+        * @class tag_program
+        * @brief boolean tag expression like "(fast & db) | (smoke & !network)", compiled to 
+        * a postfix program over interned tag ids. evaluation is one pass over the program 
+        * with a bit stack, so it costs O(tags in the expression) per test and never allocates
+        */
+        class tag_program
+        {
+        public:
+            /**
+            * @brief compile an expression, an empty one matches everything.
+            * tags nobody was tagged with compile to false
+            */
+            static std::optional<tag_program> compile(std::string_view text, std::string& error)
+            {
+                tag_program program;
+                size_t pos = 0;
+                unsigned depth = 0;
+                skip_space(text, pos);
+                if (pos == text.size()) return program;
+
+                if (!parse_or(text, pos, program, depth, error)) return std::nullopt;
+                if (pos != text.size())
+                {
+                    error = std::format("unexpected '{}' at {} in tag expression '{}'", text[pos], pos, text);
+                    return std::nullopt;
+                }
+                return program;
+            }
+
+            /**
+            * @brief evaluate, has(id) tells if the test has the tag
+            */
+            template<class Has>
+            bool eval(Has&& has) const
+            {
+                if (code.empty()) return true;
+
+                // bit 0 is the top of the stack
+                std::uint64_t stack = 0;
+                for (const auto& ins : code)
+                {
+                    switch (ins.code)
+                    {
+                    case op::tag: stack = (stack << 1) | (has(ins.id) ? 1 : 0); break;
+                    case op::never: stack <<= 1; break;
+                    case op::negate: stack ^= 1; break;
+                    case op::both: stack = (stack >> 1) & (stack | ~std::uint64_t(1)); break;
+                    case op::either: stack = (stack >> 1) | (stack & 1); break;
+                    }
+                }
+                return stack & 1;
+            }
+
+            bool empty() const noexcept
+            {
+                return code.empty();
+            }
+
+        private:
+            enum class op : std::uint8_t { tag, never, negate, both, either };
+
+            struct instruction
+            {
+                op code;
+                std::uint32_t id = 0;
+            };
+
+            static constexpr std::string_view operators = "()&|!,";
+            static constexpr unsigned max_depth = 64;     // bits in the evaluation stack
+            static constexpr unsigned max_nesting = 256;  // parentheses and '!' around one operand
+
+            static void skip_space(std::string_view text, size_t& pos)
+            {
+                while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+            }
+
+            /**
+            * @brief consume an operator, doubled ones ('&&', '||') are accepted too
+            */
+            static bool accept(std::string_view text, size_t& pos, char c)
+            {
+                if (pos >= text.size() || text[pos] != c) return false;
+                ++pos;
+                if ((c == '&' || c == '|') && pos < text.size() && text[pos] == c) ++pos;
+                skip_space(text, pos);
+                return true;
+            }
+
+            bool push(op operation, std::uint32_t id, unsigned& depth, std::string_view text, std::string& error)
+            {
+                if (operation == op::tag || operation == op::never)
+                {
+                    if (++depth > max_depth)
+                    {
+                        error = std::format("tag expression '{}' is nested too deeply", text);
+                        return false;
+                    }
+                }
+                else if (operation != op::negate) --depth;
+                code.push_back({ operation, id });
+                return true;
+            }
+
+            // or := and ('|' and)*
+            static bool parse_or(std::string_view text, size_t& pos, tag_program& program, unsigned& depth, std::string& error)
+            {
+                if (!parse_and(text, pos, program, depth, error)) return false;
+                while (accept(text, pos, '|'))
+                {
+                    if (!parse_and(text, pos, program, depth, error) ||
+                        !program.push(op::either, 0, depth, text, error)) return false;
+                }
+                return true;
+            }
+
+            // and := unary ('&' unary)*
+            static bool parse_and(std::string_view text, size_t& pos, tag_program& program, unsigned& depth, std::string& error)
+            {
+                if (!parse_unary(text, pos, program, depth, error)) return false;
+                while (accept(text, pos, '&'))
+                {
+                    if (!parse_unary(text, pos, program, depth, error) ||
+                        !program.push(op::both, 0, depth, text, error)) return false;
+                }
+                return true;
+            }
+
+            // unary := '!' unary | '(' or ')' | tag
+            static bool parse_unary(std::string_view text, size_t& pos, tag_program& program, unsigned& depth, std::string& error)
+            {
+                // bound the recursion, the operand depth alone does not limit '((((' or '!!!!'
+                if (program.nesting >= max_nesting)
+                {
+                    error = std::format("tag expression '{}' is nested too deeply", text);
+                    return false;
+                }
+                if (accept(text, pos, '!'))
+                {
+                    ++program.nesting;
+                    bool parsed = parse_unary(text, pos, program, depth, error) &&
+                        program.push(op::negate, 0, depth, text, error);
+                    --program.nesting;
+                    return parsed;
+                }
+                if (accept(text, pos, '('))
                 {
-                    st.fail++;
-                    st.failed.push_back(test.name());
+                    ++program.nesting;
+                    bool parsed = parse_or(text, pos, program, depth, error);
+                    --program.nesting;
+                    if (!parsed) return false;
+                    if (accept(text, pos, ')')) return true;
+                    error = std::format("missing ')' in tag expression '{}'", text);
+                    return false;
+                }
+
+                // tag names run up to the next operator, inner spaces are part of the name
+                size_t start = pos;
+                while (pos < text.size() && operators.find(text[pos]) == operators.npos) ++pos;
+                std::string_view tag = text.substr(start, pos - start);
+                while (!tag.empty() && std::isspace(static_cast<unsigned char>(tag.back()))) tag.remove_suffix(1);
+                if (tag.empty())
+                {
+                    error = pos < text.size() ?
+                        std::format("unexpected '{}' at {} in tag expression '{}'", text[pos], pos, text) :
+                        std::format("missing tag at the end of tag expression '{}'", text);
+                    return false;
+                }
+
+                auto id = tag_dictionary::instance().find(tag);
+                return program.push(id ? op::tag : op::never, id.value_or(0), depth, text, error);
+            }
+
+        private:
+            std::vector<instruction> code;
+            unsigned nesting = 0;       // only used while compiling
+        };
+
+        /**
+        * @struct tag_filter
+        * @brief include and exclude tags compiled to bitsets once per run, and an optional
+        * tag expression all selected tests must match as well.
+        * tags nobody was tagged with are dropped, they cannot match anything
+        */
+        struct tag_filter
+        {
+            tag_set include;
+            tag_set exclude;
+            tag_program expression;
+            bool include_all = true;        // no include tags given, everything not excluded runs
+
+            tag_filter(const include_tags& inc_tags, const exclude_tags& exc_tags, tag_program expr = {})
+                : expression(std::move(expr)),
+                include_all(inc_tags.set.empty())
+            {
+                auto& dictionary = tag_dictionary::instance();
+                for (const auto& tag : inc_tags.set)
+                {
+                    if (auto id = dictionary.find(tag)) include.insert(*id);
                 }
-                
-                if (teardown_function) teardown_function();
+                for (const auto& tag : exc_tags.set)
+                {
+                    if (auto id = dictionary.find(tag)) exclude.insert(*id);
+                }
+            }
+
+            bool excluded(const tag_set& tags) const noexcept
+            {
+                return tags.intersects(exclude);
+            }
+
+            bool included(const tag_set& tags) const noexcept
+            {
+                return include_all || tags.intersects(include);
+            }
+
+            /**
+            * @brief checks the expression against the tags of a test and its suite
+            */
+            bool matches(const tag_set& inherited, const tag_set& own) const
+            {
+                return expression.eval([&](std::uint32_t id) { return own.contains(id) || inherited.contains(id); });
+            }
+        };
+
+        /**
+        * @struct static_test
+        * @brief descriptor of a test defined with DOUGH_TEST. constant initialized, and linked 
+        * into an intrusive list during static initialization without allocating. tags are 
+        * interned and a test object is made only when a run selects it
+        */
+        struct static_test
+        {
+            /**
+            * @struct list
+            * @brief registered descriptors, in registration order within a translation unit
+            */
+            struct list
+            {
+                static_test* first;
+                static_test** last;
+            };
+
+            std::string_view suite_name;
+            std::string_view test_name;
+            std::span<const std::string_view> tag_names;
+            void (*function)() = nullptr;
+            void (*fuzz)(std::span<const std::uint8_t>) = nullptr;     // body of a DOUGH_FUZZ_TEST, instead of function
+            std::uint64_t id = 0;           // test id, known at compile time
+            static_test* next = nullptr;
+            tag_set tags;                   // interned on first use, not during static initialization
+            bool interned = false;
+            bool materialized = false;      // added to its suite as a test object
+
+            constexpr static_test(
+                std::string_view suite, 
+                std::string_view name, 
+                std::span<const std::string_view> tag_list, 
+                void (*func)()) noexcept
+                : suite_name(suite), test_name(name), tag_names(tag_list), function(func), id(test_hash(suite, name)) {}
+
+            constexpr static_test(
+                std::string_view suite, 
+                std::string_view name, 
+                std::span<const std::string_view> tag_list, 
+                void (*func)(std::span<const std::uint8_t>)) noexcept
+                : suite_name(suite), test_name(name), tag_names(tag_list), fuzz(func), id(test_hash(suite, name)) {}
+
+            /**
+            * @brief all registered descriptors
+            */
+            static list& all() noexcept
+            {
+                static constinit list registered{ nullptr, &registered.first };
+                return registered;
+            }
+
+            /**
+            * @brief append to the list, called once from the static initializer DOUGH_TEST emits
+            */
+            bool link() noexcept
+            {
+                auto& registered = all();
+                *registered.last = this;
+                registered.last = &next;
+                return true;
+            }
+
+            /**
+            * @brief get tags as interned ids
+            */
+            const tag_set& interned_tags()
+            {
+                if (interned) return tags;
+                auto& dictionary = tag_dictionary::instance();
+                for (auto tag : tag_names) tags.insert(dictionary.intern(sanitize_tag(std::string(tag))));
+                interned = true;
+                return tags;
+            }
+        };
+    }
+
+#define DOUGH_CONCAT_IMPL(a, b) a##b
+#define DOUGH_CONCAT(a, b) DOUGH_CONCAT_IMPL(a, b)
+
+#define DOUGH_TEST_IMPL(id, suite_name, test_name, ...) \
+    static void id(); \
+    static constexpr std::string_view DOUGH_CONCAT(id, _tags)[] = { std::string_view() __VA_OPT__(,) __VA_ARGS__ }; \
+    static constinit ::dough::detail::static_test DOUGH_CONCAT(id, _entry){ suite_name, test_name, \
+        std::span<const std::string_view>(DOUGH_CONCAT(id, _tags)).subspan(1), &id }; \
+    [[maybe_unused]] static const bool DOUGH_CONCAT(id, _linked) = DOUGH_CONCAT(id, _entry).link(); \
+    static void id()
+
+/**
+* @brief define a test that registers itself before main, in any translation unit:
+* DOUGH_TEST("suite", "name", "tag 1", "tag 2") { check_true(...); }
+* registration only links a constant descriptor into a list, it does not allocate.
+* the tests run with registry::global()
+*/
+#define DOUGH_TEST(suite_name, test_name, ...) \
+    DOUGH_TEST_IMPL(DOUGH_CONCAT(dough_static_test_, __COUNTER__), suite_name, test_name __VA_OPT__(,) __VA_ARGS__)
+
+#define DOUGH_FUZZ_TEST_IMPL(id, suite_name, test_name, ...) \
+    static void id(std::span<const std::uint8_t>); \
+    static constexpr std::string_view DOUGH_CONCAT(id, _tags)[] = { std::string_view() __VA_OPT__(,) __VA_ARGS__ }; \
+    static constinit ::dough::detail::static_test DOUGH_CONCAT(id, _entry){ suite_name, test_name, \
+        std::span<const std::string_view>(DOUGH_CONCAT(id, _tags)).subspan(1), &id }; \
+    [[maybe_unused]] static const bool DOUGH_CONCAT(id, _linked) = DOUGH_CONCAT(id, _entry).link(); \
+    static void id([[maybe_unused]] std::span<const std::uint8_t> data)
+
+/**
+* @brief define a fuzz test that registers itself like DOUGH_TEST, the input is called data:
+* DOUGH_FUZZ_TEST("parser", "json") { parse(data); }
+* normal runs replay its corpus, see fuzz_test(). in a build with -fsanitize=fuzzer and 
+* DOUGH_FUZZ_MAIN defined in one translation unit it is what LLVMFuzzerTestOneInput calls
+*/
+#define DOUGH_FUZZ_TEST(suite_name, test_name, ...) \
+    DOUGH_FUZZ_TEST_IMPL(DOUGH_CONCAT(dough_fuzz_test_, __COUNTER__), suite_name, test_name __VA_OPT__(,) __VA_ARGS__)
+
+    /**
+    * @struct options
+    * @brief run configuration, filled by the cli or passed to registry::run directly
+    */
+    struct options
+    {
+        std::vector<std::string> suites;    // suites to run, all if empty
+        std::string tags;                   // tag expression selected tests must match, e.g. "(fast & db) | !slow". all if empty
+        bool dry_run = false;               // print how many tests are selected instead of running them
+        std::vector<std::uint64_t> ids;     // run only the tests with these ids (test::id()), other filters do not apply
+        std::string history_file;           // test durations and results of previous runs, used to start long tests first. off if empty
+        bool failed_first = false;          // run the tests that failed in the previous run (see history_file) first
+        bool last_failed = false;           // run only the tests that failed in the previous run, all selected ones if none did
+        unsigned fail_fast = 0;             // stop the run after this many failed tests or benchmarks and cancel the rest, 0 to run all
+        unsigned jobs = 1;                  // worker threads (or processes), 0 for one per hardware thread
+        bool isolate = false;               // run tests in forked worker processes, so crashes only fail the test. posix only
+        unsigned slowest = 0;               // number of slowest tests listed in the summary
+        bool bench = false;                 // run benchmarks instead of tests, one at a time
+        std::string bench_out;              // write benchmark results here, google-benchmark json format. off if empty
+        std::string bench_baseline;         // compare benchmarks against results saved with bench_out. off if empty
+        double bench_threshold = 0.05;      // relative median slowdown that fails a benchmark, if also significant
+        double bench_alpha = 0.05;          // significance level of the mann-whitney u test
+        unsigned shard_index = 0;           // shard to run, in [0, shard_count)
+        unsigned shard_count = 1;           // number of disjoint shards the selected tests are split into
+        bool shard_by_duration = false;     // balance shards by durations from history_file instead of by test count
+        bool async_output = false;          // report through the writer thread, always on with more than one job
+        std::string reporter = "console";   // output format: console, junit, jsonl or tap
+        std::string out;                    // write the report here instead of stdout. off if empty
+        bool quiet = false;                 // console prints progress and a short summary only
+        std::uint64_t seed = 0;             // seed of property tests, printed with their failures. 0 for a random one per run
+        std::uint64_t property_cases = 100; // cases generated per property test
+        std::string corpus = "corpus";      // fuzz test inputs are read from <corpus>/<suite>/<test>
+        std::chrono::milliseconds timeout{};    // limit of tests without their own test::timeout, 0 for none
+        bool perf = false;                  // measure hardware counters (perf_event_open) and rusage of each test and benchmark. linux only
+    };
+
+    class suite;
+    class test;
+    class reporter;
+    struct bench_result;
+    struct suite_stats;
+    struct run_summary;
+
+    namespace detail
+    {
+        /**
+        * @struct failure
+        * @brief why a test or benchmark did not pass
+        */
+        struct failure
+        {
+            std::optional<test_fail> check;     // failed check
+            std::string error;                  // exception message, or how an isolated worker died
+            bool crashed = false;               // the worker process running the test died
+        };
+
+        /**
+        * @brief reporter used when tests or suites are run directly instead of through a registry
+        */
+        inline reporter& console();
+    }
+
+    /**
+    * @struct test_result
+    * @brief finished test, as passed to reporters
+    */
+    struct test_result
+    {
+        test_result(
+            const std::string& suite_name,
+            const std::string& test_name,
+            const detail::outcome& result,
+            const detail::failure& fail) noexcept
+            : suite(suite_name),
+            name(test_name),
+            id(detail::test_hash(suite_name, test_name)),
+            outcome(result),
+            failure(fail.check ? &*fail.check : nullptr),
+            error(fail.error),
+            crashed(fail.crashed)
+        {
+        }
+
+        const std::string& suite;
+        const std::string& name;
+        std::uint64_t id;                       // stable test id, see test::id()
+        const detail::outcome& outcome;
+        const detail::test_fail* failure;       // failed check, if any
+        std::string_view error;                 // exception or crash that ended the test, if any
+        bool crashed;
+    };
+
+    /**
+    * @struct case_result
+    * @brief failed case of a parameterized test, as passed to reporters
+    */
+    struct case_result
+    {
+        const std::string& suite;
+        const std::string& name;                // name of the parameterized test
+        std::uint64_t index;                    // position of the parameter in the generated sequence
+        std::string_view value;                 // formatted parameter
+        const detail::test_fail* failure;       // failed check, if any
+        std::string_view error;                 // exception that ended the case, if any
+    };
+
+    /**
+    * @struct bench_report
+    * @brief finished benchmark, as passed to reporters
+    */
+    struct bench_report
+    {
+        bench_report(
+            const std::string& suite_name,
+            const std::string& bench_name,
+            const detail::outcome& result,
+            const detail::failure& fail) noexcept
+            : suite(suite_name),
+            name(bench_name),
+            outcome(result),
+            failure(fail.check ? &*fail.check : nullptr),
+            error(fail.error)
+        {
+        }
+
+        const std::string& suite;
+        const std::string& name;
+        const detail::outcome& outcome;
+        const detail::test_fail* failure;       // failed check, if any
+        std::string_view error;                 // exception that ended the benchmark, if any
+        const bench_result* result = nullptr;   // measurements, if the benchmark finished
+        bool compared = false;                  // a baseline was given
+        const bench_result* baseline = nullptr; // baseline measurements, if the baseline has this benchmark
+        double change = 0;                      // relative median change against the baseline
+        double p_value = 1;                     // significance of the slowdown
+        double threshold = 0;                   // relative slowdown that counts as a regression
+        bool regressed = false;
+    };
+
+    /**
+    * @class reporter
+    * @brief receives run events and writes them in some format, as they happen.
+    * see console_reporter, junit_reporter, jsonl_reporter and tap_reporter.
+    * in parallel runs events come from worker threads, the registry calls
+    * a reporter under a lock unless it is concurrent()
+    */
+    class reporter
+    {
+    public:
+        virtual ~reporter() = default;
+
+        /**
+        * @brief whether the reporter may be called from several threads at once
+        */
+        virtual bool concurrent() const noexcept { return false; }
+
+        /**
+        * @brief run starts, with the number of selected tests (or benchmarks)
+        */
+        virtual void on_run_start(size_t) {}
+
+        /**
+        * @brief suite starts. only sent when suites run one after another
+        */
+        virtual void on_suite_start(const std::string&) {}
+
+        /**
+        * @brief test starts
+        */
+        virtual void on_test_start(const std::string&, const std::string&) {}
+
+        /**
+        * @brief test finished
+        */
+        virtual void on_test_end(const test_result&) {}
+
+        /**
+        * @brief case of a parameterized test failed, sent from the thread that ran it before 
+        * the test ends. passing cases are only counted in the test outcome
+        */
+        virtual void on_case_end(const case_result&) {}
+
+        /**
+        * @brief benchmark starts
+        */
+        virtual void on_bench_start(const std::string&, const std::string&) {}
+
+        /**
+        * @brief benchmark finished, compared against the baseline if there is one
+        */
+        virtual void on_bench_end(const bench_report&) {}
+
+        /**
+        * @brief all selected tests of a suite finished
+        */
+        virtual void on_suite_end(const std::string&, const suite_stats&) {}
+
+        /**
+        * @brief run finished
+        */
+        virtual void on_summary(const run_summary&) {}
+
+        /**
+        * @brief list registered suites, tests and benchmarks
+        */
+        virtual void on_list(const std::vector<suite>&) {}
+    };
+
+    namespace detail
+    {
+        /**
+        * @brief a lazy range of test parameters, or a callable making one. ranges that can 
+        * be iterated only once, like coroutine generators, have to come from a callable
+        */
+        template<class G>
+        concept param_source = 
+            std::ranges::input_range<G> ||
+            (std::invocable<G&> && std::ranges::input_range<std::invoke_result_t<G&>>);
+
+        /**
+        * @brief format a test parameter for reports. strings are quoted, containers, tuples 
+        * and pairs printed element-wise, other types without operator<< as '?'
+        */
+        template<class T>
+        void value_print(std::ostream& out, const T& value)
+        {
+            if constexpr (std::convertible_to<const T&, std::string_view>)
+            {
+                out << '"' << std::string_view(value) << '"';
+            }
+            else if constexpr (std::same_as<T, signed char> || std::same_as<T, unsigned char>)
+            {
+                out << static_cast<int>(value);     // int8_t and uint8_t are numbers, not characters
+            }
+            else if constexpr (requires { out << value; })
+            {
+                out << value;
+            }
+            else if constexpr (std::ranges::input_range<const T>)
+            {
+                out << '[';
+                const char* separator = "";
+                for (const auto& item : value)
+                {
+                    out << separator;
+                    value_print(out, item);
+                    separator = ", ";
+                }
+                out << ']';
+            }
+            else if constexpr (requires { std::tuple_size<T>::value; })
+            {
+                out << '(';
+                std::apply([&](const auto&... items)
+                    {
+                        const char* separator = "";
+                        ((out << separator, value_print(out, items), separator = ", "), ...);
+                    }, value);
+                out << ')';
+            }
+            else
+            {
+                out << '?';
+            }
+        }
+
+        template<class T>
+        std::string value_format(const T& value)
+        {
+            std::stringstream result;
+            result << std::boolalpha;
+            result.precision(10);
+            value_print(result, value);
+            return result.str();
+        }
+
+        struct case_access;
+
+        /**
+        * @struct deadline
+        * @brief time limit of a running test
+        */
+        struct deadline
+        {
+            explicit deadline(std::chrono::nanoseconds time_limit) noexcept
+                : start(std::chrono::steady_clock::now()), end(start + time_limit), limit(time_limit)
+            {
+            }
+
+            /**
+            * @brief whether the test is over time
+            */
+            bool passed() const noexcept
+            {
+                return expired.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= end;
+            }
+
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+            std::chrono::nanoseconds limit;
+            std::atomic<bool> expired = false;      // set by the watchdog once end has passed
+        };
+
+        /**
+        * @brief deadline of the test running on this thread, for remaining_time(). nullptr if it has none
+        */
+        inline thread_local const deadline* current_deadline = nullptr;
+
+        /**
+        * @class watchdog
+        * @brief thread that reports tests still running past their deadline, so a hung test 
+        * is named in the log while it hangs. a test thread cannot be stopped from outside: 
+        * the test fails once it returns, and can return early by checking remaining_time()
+        */
+        class watchdog
+        {
+        public:
+            watchdog()
+            {
+                thread = std::thread([this]() { loop(); });
+            }
+
+            ~watchdog()
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                thread.join();
+            }
+
+            watchdog(const watchdog&) = delete;
+            watchdog& operator=(const watchdog&) = delete;
+
+            /**
+            * @brief watch the deadline of a test until unwatch, names must outlive that
+            */
+            void watch(deadline& time, const std::string& suite_name, const std::string& test_name)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    entries.push_back({ &time, &suite_name, &test_name });
+                }
+                wake.notify_one();
+            }
+
+            void unwatch(const deadline& time)
+            {
+                std::lock_guard lock(mutex);
+                std::erase_if(entries, [&](const entry& e) { return e.time == &time; });
+            }
+
+        private:
+            struct entry
+            {
+                deadline* time;
+                const std::string* suite_name;
+                const std::string* test_name;
+            };
+
+            /**
+            * @brief sleep until the nearest deadline, report the tests past theirs
+            */
+            void loop()
+            {
+                std::unique_lock lock(mutex);
+                while (!stopping)
+                {
+                    auto now = std::chrono::steady_clock::now();
+                    auto next = std::chrono::steady_clock::time_point::max();
+                    for (auto& e : entries)
+                    {
+                        if (e.time->expired.load(std::memory_order_relaxed)) continue;
+                        if (e.time->end > now)
+                        {
+                            next = std::min(next, e.time->end);
+                            continue;
+                        }
+                        e.time->expired.store(true, std::memory_order_relaxed);
+                        print_error(std::format("[TIME ] {} :: {} still running after {}, over its timeout of {}\n", *e.suite_name, 
+                            *e.test_name, duration_format(now - e.time->start), duration_format(e.time->limit)));
+                    }
+                    if (next == std::chrono::steady_clock::time_point::max()) wake.wait(lock);
+                    else wake.wait_until(lock, next);
+                }
+            }
+
+        private:
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::vector<entry> entries;
+            bool stopping = false;
+            std::thread thread;
+        };
+
+        /**
+        * @struct run_context
+        * @brief settings of a run that tests with many cases need
+        */
+        struct run_context
+        {
+            unsigned jobs = 1;                      // threads the cases of one test may run on
+            std::uint64_t seed = 0;                 // seed of property tests, 0 picks a random one
+            std::uint64_t property_cases = 100;     // cases generated per property test
+            std::string corpus = "corpus";          // root of the fuzz test corpora
+            std::chrono::nanoseconds timeout{};     // limit of tests without their own, 0 for none
+            watchdog* watch = nullptr;              // reports tests over their limit while they run
+            bool perf = false;                      // measure hardware counters and rusage of tests
+        };
+
+        /**
+        * @class deadline_scope
+        * @brief gives the running test its deadline, if it has a limit: sets it for remaining_time() 
+        * and hands it to the watchdog until the scope ends
+        */
+        class deadline_scope
+        {
+        public:
+            deadline_scope(std::chrono::nanoseconds limit, watchdog* watch, const std::string& suite_name, const std::string& test_name)
+                : previous(current_deadline), watch(watch)
+            {
+                if (limit.count() <= 0) return;
+                time.emplace(limit);
+                current_deadline = &*time;
+                if (watch) watch->watch(*time, suite_name, test_name);
+            }
+
+            ~deadline_scope()
+            {
+                if (time && watch) watch->unwatch(*time);
+                current_deadline = previous;
+            }
+
+            deadline_scope(const deadline_scope&) = delete;
+            deadline_scope& operator=(const deadline_scope&) = delete;
+
+            /**
+            * @brief fail a test that passed but ran over its limit
+            */
+            void check(outcome& result, failure& fail) const
+            {
+                if (!time || !result.passed || !time->passed()) return;
+                result.passed = false;
+                result.timed_out = true;
+                fail.error = std::format("timed out after {} (limit {})", duration_format(since(time->start)), duration_format(time->limit));
+            }
+
+        private:
+            std::optional<deadline> time;
+            const deadline* previous;
+            watchdog* watch;
+        };
+
+        /**
+        * @class case_runner
+        * @brief runs the cases of a parameterized or property test and counts them into the 
+        * test outcome. the first failed case (by index) becomes the failure of the test, every 
+        * failed case goes to the reporter. with more than one job, workers pull chunks of 
+        * parameters from the shared range, so memory stays at jobs * chunk_size parameters
+        */
+        class case_runner
+        {
+        public:
+            static constexpr size_t chunk_size = 256;
+
+            case_runner(
+                const std::string& suite_name,
+                const std::string& test_name,
+                reporter* rep,
+                const run_context& ctx,
+                outcome& result,
+                failure& fail) noexcept
+                : suite_name(suite_name), test_name(test_name), rep(rep), ctx(ctx), result(result), fail(fail)
+            {
+            }
+
+            /**
+            * @brief call body with every element of range, spread over the jobs
+            */
+            template<class R, class F>
+            void run(R& range, F& body)
+            {
+                if (ctx.jobs <= 1)
+                {
+                    std::uint64_t index = 0, failed = 0;
+                    for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it)
+                    {
+                        if (index % chunk_size == 0 && expired()) break;
+                        if (!call(body, *it, index++)) ++failed;
+                    }
+                    count(index, failed);
+                    return;
+                }
+
+                using value_type = std::ranges::range_value_t<R>;
+
+                std::mutex source_mutex;
+                auto it = std::ranges::begin(range);
+                auto end = std::ranges::end(range);
+                std::uint64_t next_index = 0;
+                bool source_failed = false;
+
+                spread([&]()
+                    {
+                        std::vector<value_type> chunk;
+                        {
+                            alloc_pause pause;
+                            chunk.reserve(chunk_size);
+                        }
+                        std::uint64_t done = 0, failed = 0;
+                        try
+                        {
+                            while (true)
+                            {
+                                chunk.clear();
+                                std::uint64_t first = 0;
+                                {
+                                    std::lock_guard lock(source_mutex);
+                                    if (source_failed || expired()) break;
+                                    for (; it != end && chunk.size() < chunk_size; ++it) chunk.emplace_back(*it);
+                                    first = next_index;
+                                    next_index += chunk.size();
+                                }
+                                if (chunk.empty()) break;
+
+                                for (size_t i = 0; i < chunk.size(); ++i)
+                                {
+                                    if (!call(body, chunk[i], first + i)) ++failed;
+                                }
+                                done += chunk.size();
+                            }
+                        }
+                        catch (...)
+                        {
+                            // only the range itself can throw here, cases catch their own errors
+                            {
+                                std::lock_guard lock(source_mutex);
+                                source_failed = true;
+                            }
+                            count(done, failed);
+                            throw;
+                        }
+                        count(done, failed);
+                    });
+            }
+
+            /**
+            * @brief call worker on ctx.jobs threads, the calling one included. the first 
+            * exception escaping a worker is rethrown once all of them have finished
+            */
+            template<class F>
+            void spread(F&& worker)
+            {
+                std::exception_ptr error;
+                const deadline* time = current_deadline;
+                auto guarded = [&](bool helper)
+                    {
+                        current_deadline = time;
+                        alloc_scope allocs;
+                        perf_scope perf(helper && ctx.perf);
+                        auto cpu_start = thread_cpu_time();
+                        try
+                        {
+                            worker();
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard lock(result_mutex);
+                            if (!error) error = std::current_exception();
+                        }
+                        auto memory = allocs.stop();
+                        if (!helper) return;
+                        auto cpu = thread_cpu_time() - cpu_start;
+                        auto counters = perf.stop();
+                        std::lock_guard lock(result_mutex);
+                        helper_cpu_time += cpu;
+                        helper_alloc_usage += memory;
+                        helper_perf_usage += counters;
+                    };
+
+                // the thread states are freed by the helpers once their scopes stopped, 
+                // so neither they nor the vector are billed to the test
+                std::vector<std::thread> workers;
+                {
+                    alloc_pause pause;
+                    workers.reserve(ctx.jobs - 1);
+                    for (unsigned i = 1; i < ctx.jobs; ++i) workers.emplace_back(guarded, true);
+                }
+                guarded(false);
+                for (auto& w : workers) w.join();
+
+                if (error) std::rethrow_exception(error);
+            }
+
+            /**
+            * @brief add finished cases to the outcome
+            */
+            void count(std::uint64_t done, std::uint64_t failed)
+            {
+                std::lock_guard lock(result_mutex);
+                result.cases += done;
+                result.failed_cases += failed;
+            }
+
+            /**
+            * @brief report a failed case, it becomes the failure of the test if it has the lowest index so far
+            */
+            DOUGH_COLD void failed_case(std::uint64_t index, const std::string& value, const test_fail* check, std::string_view error)
+            {
+                alloc_pause pause;
+                {
+                    std::lock_guard lock(result_mutex);
+                    if (index < first_failed)
+                    {
+                        first_failed = index;
+                        auto where = std::format("case #{} ({})", index, value);
+                        if (check)
+                        {
+                            fail.check = *check;
+                            fail.check->text = check->text.empty() ? where : std::format("{}: {}", where, check->text);
+                            fail.error.clear();
+                        }
+                        else
+                        {
+                            fail.check.reset();
+                            fail.error = std::format("{}: {}", where, error);
+                        }
+                    }
+                }
+                if (rep) rep->on_case_end(case_result{ suite_name, test_name, index, value, check, error });
+            }
+
+            /**
+            * @brief whether the test is over its timeout, remaining cases are skipped then
+            */
+            bool expired() const noexcept
+            {
+                return current_deadline && current_deadline->passed();
+            }
+
+            const run_context& context() const noexcept
+            {
+                return ctx;
+            }
+
+            const std::string& suite() const noexcept
+            {
+                return suite_name;
+            }
+
+            const std::string& name() const noexcept
+            {
+                return test_name;
+            }
+
+            /**
+            * @brief cpu time of the helper threads, the calling thread is measured by the test
+            */
+            std::chrono::nanoseconds helper_cpu() const noexcept
+            {
+                return helper_cpu_time;
+            }
+
+            /**
+            * @brief heap usage of the helper threads, the calling thread is measured by the test
+            */
+            const alloc_usage& helper_memory() const noexcept
+            {
+                return helper_alloc_usage;
+            }
+
+            /**
+            * @brief counters and rusage of the helper threads, the calling thread is measured by the test
+            */
+            const perf_usage& helper_perf() const noexcept
+            {
+                return helper_perf_usage;
+            }
+
+        private:
+            /**
+            * @brief run one case, false if it failed
+            */
+            template<class F, class V>
+            bool call(F& body, V&& value, std::uint64_t index)
+            {
+                try
+                {
+                    if constexpr (std::invocable<F&, V&>) std::invoke(body, value);
+                    else std::apply(body, value);
+                    return true;
+                }
+                catch (const test_fail& f)
+                {
+                    alloc_pause pause;
+                    failed_case(index, value_format(value), &f, {});
+                }
+                catch (const std::exception& e)
+                {
+                    alloc_pause pause;
+                    failed_case(index, value_format(value), nullptr, *e.what() ? e.what() : "unknown exception");
+                }
+                catch (...)
+                {
+                    alloc_pause pause;
+                    failed_case(index, value_format(value), nullptr, "unknown exception");
+                }
+                return false;
+            }
+
+        private:
+            const std::string& suite_name;
+            const std::string& test_name;
+            reporter* rep;
+            const run_context& ctx;
+            outcome& result;
+            failure& fail;
+            std::mutex result_mutex;
+            std::uint64_t first_failed = std::numeric_limits<std::uint64_t>::max();
+            std::chrono::nanoseconds helper_cpu_time{};
+            alloc_usage helper_alloc_usage;
+            perf_usage helper_perf_usage;
+        };
+
+        /**
+        * @struct fixture_ref
+        * @brief fixture of the suite whose test runs on this thread, see suite::fixture()
+        */
+        struct fixture_ref
+        {
+            const std::type_info* type = nullptr;
+            void* object = nullptr;
+        };
+
+        inline thread_local fixture_ref current_fixture;
+
+        /**
+        * @brief fixture of the running test, throws if its suite has none of that type
+        */
+        template<class Fixture>
+        Fixture& fixture_get()
+        {
+            if (!current_fixture.object || *current_fixture.type != typeid(Fixture))
+            {
+                throw std::logic_error(std::format("the suite does not provide a fixture of type '{}'", typeid(Fixture).name()));
+            }
+            return *static_cast<Fixture*>(current_fixture.object);
+        }
+
+        /**
+        * @brief fixture type a test body takes by reference, e.g. database for [](database& db) { ... }
+        */
+        template<class F, class = void>
+        struct fixture_arg {};
+
+        template<class F>
+        struct fixture_arg<F, std::void_t<decltype(&F::operator())>> : fixture_arg<decltype(&F::operator())> {};
+
+        template<class C, class R, class A>
+        struct fixture_arg<R(C::*)(A&) const, void> { using type = A; };
+
+        template<class C, class R, class A>
+        struct fixture_arg<R(C::*)(A&), void> { using type = A; };
+
+        template<class R, class A>
+        struct fixture_arg<R(*)(A&), void> { using type = A; };
+
+        template<class F>
+        concept fixture_body = requires { typename fixture_arg<F>::type; };
+    }
+
+    /**
+    * @brief time the running test has left before its timeout, zero once it is over. 
+    * nanoseconds::max() for a test without a timeout or outside of a test. 
+    * long loops can check it to stop early instead of being reported as hung
+    */
+    inline std::chrono::nanoseconds remaining_time() noexcept
+    {
+        const auto* time = detail::current_deadline;
+        if (!time) return std::chrono::nanoseconds::max();
+        if (time->expired.load(std::memory_order_relaxed)) return {};
+        auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(time->end - std::chrono::steady_clock::now());
+        return std::max(left, std::chrono::nanoseconds::zero());
+    }
+
+    /**
+    * @class test
+    * @brief represents a single test
+    */
+    class test
+    {
+        friend class suite;
+        friend struct detail::case_access;
+
+    public:
+        test(std::string name) noexcept
+            : test_name(std::move(name)),
+            test_id(detail::test_hash({}, test_name)) {}
+        test(const test& src) = default;
+        test(test&& src) noexcept = default;
+        test& operator=(const test& src) = default;
+        test& operator=(test&& src) noexcept = default;
+
+        /**
+        * @brief set test function. small callables are stored inline
+        */
+        test& func(detail::small_function<void()> test_func) noexcept
+        {
+            if (test_func) function = std::move(test_func);
+            return *this;
+        }
+
+        /**
+        * @brief set test function taking the fixture of its suite, e.g. func([](database& db) { ... }). 
+        * the test fails if the suite has no fixture of that type, see suite::fixture()
+        */
+        template<class F>
+            requires detail::fixture_body<std::decay_t<F>>
+        test& func(F&& test_func)
+        {
+            using fixture_type = typename detail::fixture_arg<std::decay_t<F>>::type;
+            function = [body = std::forward<F>(test_func)]() mutable { body(detail::fixture_get<fixture_type>()); };
+            return *this;
+        }
+
+        /**
+        * @brief make a parameterized test: body runs once per element of generator, a lazy range
+        * (e.g. std::views::iota(0, 1'000'000)) or a callable returning one, for single-pass ranges 
+        * like coroutine generators. parameters are never stored all at once, tuple elements are 
+        * passed as separate arguments if body takes them so. each case passes or fails on its own,
+        * a failed case is reported with its index and value. with more than one job the cases 
+        * are spread over that many threads in chunks, so body must be thread-safe then.
+        * replaces the test function
+        */
+        template<class G, class F>
+            requires detail::param_source<std::decay_t<G>>
+        test& params(G&& generator, F&& body)
+        {
+            cases = [source = std::forward<G>(generator), body = std::forward<F>(body)](detail::case_runner& runner) mutable
+                {
+                    if constexpr (std::ranges::input_range<decltype(source)>)
+                    {
+                        runner.run(source, body);
+                    }
+                    else
+                    {
+                        auto range = source();
+                        runner.run(range, body);
+                    }
+                };
+            return *this;
+        }
+
+        /**
+        * @brief fail the test if it runs longer than limit, e.g. timeout(500ms). overrides 
+        * options::timeout. the watchdog names a test as soon as it is over time, but a test 
+        * running in-process only stops when it returns, see remaining_time(). 
+        * with process isolation its worker is killed instead
+        */
+        test& timeout(std::chrono::nanoseconds limit) noexcept
+        {
+            time_limit = limit;
+            return *this;
+        }
+
+        /**
+        * @brief get own time limit, 0 if the test has none
+        */
+        std::chrono::nanoseconds timeout() const noexcept
+        {
+            return time_limit;
+        }
+
+        /**
+        * @brief add test tags
+        */
+        template<typename First, typename... Rest>
+            requires 
+        (std::convertible_to<First, std::string> &&
+        (std::convertible_to<Rest, std::string> && ...))
+            test& tags(First&& first, Rest&&... rest) noexcept
+        {
+            detail::tags_insert(tag_set, std::forward<First>(first), std::forward<Rest>(rest)...);
+            return *this;
+        }
+
+        /**
+        * @brief get tag names, own and inherited from the suite, sorted
+        */
+        std::vector<std::string_view> tags() const
+        {
+            if (!inherited) return detail::tags_names(tag_set);
+            detail::tag_set all = *inherited;
+            all |= tag_set;
+            return detail::tags_names(all);
+        }
+
+        /**
+        * @brief set name
+        */
+        test& name(std::string new_name) noexcept
+        {
+            test_name = std::move(new_name);
+            test_id = detail::test_hash(owner_name, test_name);
+            return *this;
+        }
+
+        /**
+        * @brief get name
+        */
+        const std::string& name() const noexcept
+        {
+            return test_name;
+        }
+
+        /**
+        * @brief get stable id, a hash of 'suite::test'. it does not change between runs 
+        * or builds, so tools can use it as a key, e.g. with --run-id
+        */
+        std::uint64_t id() const noexcept
+        {
+            return test_id;
+        }
+
+        /**
+        * @brief run the test
+        */
+        bool run()
+        {
+            detail::outcome result;
+            detail::failure fail;
+            auto& rep = detail::console();
+            rep.on_test_start(owner_name, test_name);
+            run(result, fail, &rep);
+            rep.on_test_end(test_result(owner_name, test_name, result, fail));
+            return result.passed;
+        }
+
+    private:
+        /**
+        * @brief run the test, measuring wall and cpu time of the test function.
+        * a failed check or exception is kept in fail, reporting is up to the caller.
+        * failed cases of a parameterized or property test go to rep, its cases run on up to ctx.jobs threads.
+        * a test over its limit (or ctx.timeout) fails, ctx.watch reports it while it runs
+        */
+        void run(detail::outcome& result, detail::failure& fail, reporter* rep = nullptr, const detail::run_context& ctx = {})
+        {
+            detail::deadline_scope time(time_limit.count() > 0 ? time_limit : ctx.timeout, ctx.watch, owner_name, test_name);
+            if (cases) run_cases(result, fail, rep, ctx);
+            else if (function) run_function(result, fail, ctx);
+            time.check(result, fail);
+        }
+
+        /**
+        * @brief run the test function
+        */
+        void run_function(detail::outcome& result, detail::failure& fail, const detail::run_context& ctx)
+        {
+            detail::alloc_scope allocs;
+            detail::perf_scope perf(ctx.perf);
+            auto wall_start = std::chrono::steady_clock::now();
+            auto cpu_start = detail::thread_cpu_time();
+            auto stop = [&]()
+                {
+                    result.wall = detail::since(wall_start);
+                    result.cpu = detail::thread_cpu_time() - cpu_start;
+                    result.perf = perf.stop();
+                };
+
+            // the copies of the failure are the framework's, and the heap is counted only 
+            // once the exception is gone, so neither shows up as leaked by the test
+            try
+            {
+                function();
+                stop();
+                result.passed = true;
+            }
+            catch (const detail::test_fail& f)
+            {
+                stop();
+                detail::alloc_pause pause;
+                fail.check = f;
+            }
+            catch (const std::exception& e)
+            {
+                stop();
+                detail::alloc_pause pause;
+                fail.error = *e.what() ? e.what() : "unknown exception";
+            }
+            catch (...)
+            {
+                stop();
+                detail::alloc_pause pause;
+                fail.error = "unknown exception";
+            }
+            result.memory = allocs.stop();
+        }
+
+        /**
+        * @brief run the cases of a parameterized or property test, it passes if all of them do
+        */
+        void run_cases(detail::outcome& result, detail::failure& fail, reporter* rep, const detail::run_context& ctx)
+        {
+            detail::case_runner runner(owner_name, test_name, rep, ctx, result, fail);
+
+            detail::alloc_scope allocs;
+            detail::perf_scope perf(ctx.perf);
+            auto wall_start = std::chrono::steady_clock::now();
+            auto cpu_start = detail::thread_cpu_time();
+            try
+            {
+                cases(runner);
+            }
+            catch (const std::exception& e)
+            {
+                detail::alloc_pause pause;
+                fail.error = std::format("parameter generator threw: {}", *e.what() ? e.what() : "unknown exception");
+            }
+            catch (...)
+            {
+                detail::alloc_pause pause;
+                fail.error = "parameter generator threw: unknown exception";
+            }
+            result.wall = detail::since(wall_start);
+            result.cpu = detail::thread_cpu_time() - cpu_start + runner.helper_cpu();
+            result.perf = perf.stop();
+            result.perf += runner.helper_perf();
+            result.memory = allocs.stop();
+            result.memory += runner.helper_memory();
+            result.passed = result.failed_cases == 0 && fail.error.empty();
+        }
+
+        /**
+        * @brief set owner suite
+        */
+        void owner(const std::string& name) noexcept
+        {
+            owner_name = name;
+            test_id = detail::test_hash(owner_name, test_name);
+        }
+
+    private:
+        detail::tag_set tag_set;                                // own tags
+        std::shared_ptr<const detail::tag_set> inherited;       // tags of the owner suite, shared by all its tests
+        detail::small_function<void()> function;
+        detail::small_function<void(detail::case_runner&)> cases;  // parameterized body, see params()
+        std::chrono::nanoseconds time_limit{};                  // see timeout(), 0 for none
+        std::string test_name;
+        std::string owner_name;
+        std::uint64_t test_id = 0;
+    };
+
+    namespace detail
+    {
+        /**
+        * @brief splitmix64 step, turns a counter into well mixed bits
+        */
+        constexpr std::uint64_t splitmix64(std::uint64_t& state) noexcept
+        {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        /**
+        * @brief seed for a run that did not ask for one
+        */
+        inline std::uint64_t random_seed()
+        {
+            std::random_device device;
+            std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+            return seed == 0 ? 1 : seed;
+        }
+
+        /**
+        * @class prng
+        * @brief xoshiro256** generator. small, fast and the same on every platform, 
+        * so a seed reproduces the same values everywhere
+        */
+        class prng
+        {
+        public:
+            explicit prng(std::uint64_t seed) noexcept
+            {
+                for (auto& word : state) word = splitmix64(seed);
+            }
+
+            std::uint64_t next() noexcept
+            {
+                std::uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+                std::uint64_t t = state[1] << 17;
+                state[2] ^= state[0];
+                state[3] ^= state[1];
+                state[1] ^= state[2];
+                state[0] ^= state[3];
+                state[2] ^= t;
+                state[3] = std::rotl(state[3], 45);
+                return result;
+            }
+
+            /**
+            * @brief uniform in [0, bound), 0 if bound is 0
+            */
+            std::uint64_t below(std::uint64_t bound) noexcept
+            {
+                if (bound == 0) return 0;
+                std::uint64_t threshold = (0 - bound) % bound;     // rejecting these removes the modulo bias
+                std::uint64_t r = next();
+                while (r < threshold) r = next();
+                return r % bound;
+            }
+
+            /**
+            * @brief uniform in [lo, hi]
+            */
+            template<std::integral T>
+            T between(T lo, T hi) noexcept
+            {
+                // in unsigned 64-bit arithmetic the span is right for signed types too
+                std::uint64_t span = static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo);
+                std::uint64_t offset = span == std::numeric_limits<std::uint64_t>::max() ? next() : below(span + 1);
+                return static_cast<T>(static_cast<std::uint64_t>(lo) + offset);
+            }
+
+            /**
+            * @brief uniform in [0, 1)
+            */
+            double uniform() noexcept
+            {
+                return static_cast<double>(next() >> 11) * 0x1.0p-53;
+            }
+
+        private:
+            std::uint64_t state[4];
+        };
+
+        /**
+        * @struct arbitrary
+        * @brief default generator of a type, see the specializations after gen
+        */
+        template<class T>
+        struct arbitrary {};
+
+        /**
+        * @brief container that generators can build element by element
+        */
+        template<class T>
+        concept sequence = requires(T container, typename T::value_type value)
+        {
+            container.push_back(value);
+            container.erase(container.begin(), container.end());
+            { container.size() } -> std::convertible_to<size_t>;
+        };
+
+        /**
+        * @brief shrink candidates of a number, moving it toward target: target first, 
+        * then ever closer to the value
+        */
+        template<class T>
+        std::vector<T> shrink_number(T value, T target)
+        {
+            std::vector<T> candidates;
+            if (value == target) return candidates;
+            candidates.push_back(target);
+            if constexpr (std::integral<T> && !std::same_as<T, bool>)
+            {
+                // difference taken unsigned, target lies between zero and value, so it fits
+                using U = std::make_unsigned_t<T>;
+                bool up = value > target;
+                U distance = up ? static_cast<U>(static_cast<U>(value) - static_cast<U>(target)) :
+                    static_cast<U>(static_cast<U>(target) - static_cast<U>(value));
+                for (U step = distance / 2; step > 0; step /= 2)
+                {
+                    candidates.push_back(static_cast<T>(up ? static_cast<U>(value) - step : static_cast<U>(value) + step));
+                }
+            }
+            else if constexpr (std::floating_point<T>)
+            {
+                if (std::trunc(value) != value && std::trunc(value) != target) candidates.push_back(std::trunc(value));
+                T half = target + (value - target) / 2;
+                if (half != value && half != target) candidates.push_back(half);
+            }
+            return candidates;
+        }
+
+        /**
+        * @brief shrink candidates of a container: empty, then with chunks removed, 
+        * then with one element shrunk
+        */
+        template<class C, class Element>
+        std::vector<C> shrink_sequence(const C& value, const Element& element)
+        {
+            std::vector<C> candidates;
+            size_t size = value.size();
+            if (size == 0) return candidates;
+            candidates.emplace_back();
+            for (size_t chunk = size / 2; chunk > 0; chunk /= 2)
+            {
+                for (size_t start = 0; start + chunk <= size; start += chunk)
+                {
+                    if (chunk == size) continue;
+                    C smaller = value;
+                    smaller.erase(std::next(smaller.begin(), start), std::next(smaller.begin(), start + chunk));
+                    candidates.push_back(std::move(smaller));
+                }
+            }
+            size_t index = 0;
+            for (auto it = value.begin(); it != value.end(); ++it, ++index)
+            {
+                for (auto&& item : element.shrink(*it))
+                {
+                    C smaller = value;
+                    *std::next(smaller.begin(), index) = std::move(item);
+                    candidates.push_back(std::move(smaller));
+                }
+            }
+            return candidates;
+        }
+    }
+
+    /**
+    * @class gen
+    * @brief generator of random test values for property(). makes a value from a prng and
+    * a size hint, which grows with the case index, and lists smaller candidates of a value
+    * for shrinking. gen<T>() is the default generator of arithmetic types, strings and 
+    * containers of those; the static functions and map and filter build others
+    */
+    template<class T>
+    class gen
+    {
+    public:
+        using value_type = T;
+        using make_function = detail::small_function<T(detail::prng&, size_t)>;
+        using shrink_function = detail::small_function<std::vector<T>(const T&)>;
+
+        gen() requires requires { detail::arbitrary<T>::make(); }
+            : gen(detail::arbitrary<T>::make())
+        {
+        }
+
+        /**
+        * @brief generator from make_func(prng&, size) and shrink_func(value)
+        */
+        template<class Make>
+            requires (!std::same_as<std::remove_cvref_t<Make>, gen>)
+        gen(Make&& make_func, shrink_function shrink_func = nullptr)
+            : make(std::forward<Make>(make_func)), shrinker(std::move(shrink_func))
+        {
+        }
+
+        /**
+        * @brief make a value, size is a hint of how big it should be
+        */
+        T operator()(detail::prng& rng, size_t size) const
+        {
+            return make(rng, size);
+        }
+
+        /**
+        * @brief smaller values to try in place of value, most promising first
+        */
+        std::vector<T> shrink(const T& value) const
+        {
+            return shrinker ? shrinker(value) : std::vector<T>{};
+        }
+
+        /**
+        * @brief generator of func(value). mapped values are not shrunk
+        */
+        template<class F>
+        auto map(F func) const
+        {
+            using U = std::decay_t<std::invoke_result_t<F&, const T&>>;
+            return gen<U>([source = *this, func](detail::prng& rng, size_t size) { return func(source(rng, size)); });
+        }
+
+        /**
+        * @brief generator of the values passing pred. gives up after 100 rejected values in a row
+        */
+        template<class P>
+        gen filter(P pred) const
+        {
+            return gen(
+                [source = *this, pred](detail::prng& rng, size_t size)
+                {
+                    for (int attempt = 0; attempt < 100; ++attempt)
+                    {
+                        T value = source(rng, size + attempt / 10);
+                        if (pred(value)) return value;
+                    }
+                    throw std::runtime_error("gen::filter rejected 100 values in a row");
+                },
+                [source = *this, pred](const T& value)
+                {
+                    auto candidates = source.shrink(value);
+                    std::erase_if(candidates, [&](const T& candidate) { return !pred(candidate); });
+                    return candidates;
+                });
+        }
+
+        /**
+        * @brief always value
+        */
+        static gen just(T value)
+        {
+            return gen([value](detail::prng&, size_t) { return value; });
+        }
+
+        /**
+        * @brief one of values, shrinks toward the front of the list
+        */
+        static gen element_of(std::vector<T> values)
+        {
+            auto shared = std::make_shared<const std::vector<T>>(std::move(values));
+            return gen(
+                [shared](detail::prng& rng, size_t) { return (*shared)[rng.below(shared->size())]; },
+                [shared](const T& value)
+                {
+                    std::vector<T> candidates;
+                    if constexpr (std::equality_comparable<T>)
+                    {
+                        auto it = std::find(shared->begin(), shared->end(), value);
+                        auto index = static_cast<size_t>(it - shared->begin());
+                        if (index > 0 && index < shared->size()) candidates.push_back(shared->front());
+                        if (index / 2 > 0 && index < shared->size()) candidates.push_back((*shared)[index / 2]);
+                    }
+                    return candidates;
+                });
+        }
+
+        /**
+        * @brief value of one of choices, picked at random. not shrunk
+        */
+        static gen one_of(std::vector<gen> choices)
+        {
+            auto shared = std::make_shared<const std::vector<gen>>(std::move(choices));
+            return gen([shared](detail::prng& rng, size_t size) { return (*shared)[rng.below(shared->size())](rng, size); });
+        }
+
+        /**
+        * @brief number in [lo, hi], shrinks toward the one closest to zero
+        */
+        static gen between(T lo, T hi) requires std::is_arithmetic_v<T>
+        {
+            T target = std::clamp(T(0), lo, hi);
+            return gen(
+                [lo, hi](detail::prng& rng, size_t)
+                {
+                    if constexpr (std::floating_point<T>) return static_cast<T>(lo + (hi - lo) * rng.uniform());
+                    else return rng.between(lo, hi);
+                },
+                [target](const T& value) { return detail::shrink_number(value, target); });
+        }
+
+        /**
+        * @brief container of up to max_size elements made by element
+        */
+        template<class E>
+            requires detail::sequence<T> && std::same_as<E, typename T::value_type>
+        static gen of(gen<E> element, size_t max_size = 100)
+        {
+            return gen(
+                [element, max_size](detail::prng& rng, size_t size)
+                {
+                    T container;
+                    size_t count = static_cast<size_t>(rng.below(std::min(size, max_size) + 1));
+                    for (size_t i = 0; i < count; ++i) container.push_back(element(rng, size));
+                    return container;
+                },
+                [element](const T& value) { return detail::shrink_sequence(value, element); });
+        }
+
+    private:
+        make_function make;
+        shrink_function shrinker;
+    };
+
+    namespace detail
+    {
+        template<>
+        struct arbitrary<bool>
+        {
+            static gen<bool> make()
+            {
+                return gen<bool>(
+                    [](prng& rng, size_t) { return (rng.next() & 1) != 0; },
+                    [](const bool& value) { return value ? std::vector<bool>{ false } : std::vector<bool>{}; });
+            }
+        };
+
+        /**
+        * @brief printable ascii, shrinks toward 'a'
+        */
+        template<>
+        struct arbitrary<char>
+        {
+            static gen<char> make()
+            {
+                return gen<char>(
+                    [](prng& rng, size_t) { return rng.between<char>(' ', '~'); },
+                    [](const char& value) { return shrink_number(value, 'a'); });
+            }
+        };
+
+        /**
+        * @brief mostly small numbers, growing with the size, and now and then an edge case
+        */
+        template<std::integral T>
+        struct arbitrary<T>
+        {
+            static gen<T> make()
+            {
+                return gen<T>(
+                    [](prng& rng, size_t size)
+                    {
+                        constexpr T edges[] = { T(0), T(1), static_cast<T>(-1), std::numeric_limits<T>::min(), std::numeric_limits<T>::max() };
+                        if (rng.below(10) == 0) return edges[rng.below(std::size(edges))];
+                        T limit = static_cast<T>(std::min<std::uint64_t>(size, static_cast<std::uint64_t>(std::numeric_limits<T>::max())));
+                        return rng.between<T>(std::is_signed_v<T> ? static_cast<T>(-limit) : T(0), limit);
+                    },
+                    [](const T& value) { return shrink_number(value, T(0)); });
+            }
+        };
+
+        template<std::floating_point T>
+        struct arbitrary<T>
+        {
+            static gen<T> make()
+            {
+                return gen<T>(
+                    [](prng& rng, size_t size)
+                    {
+                        constexpr T edges[] = { T(0), T(1), T(-1), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(),
+                            std::numeric_limits<T>::min(), std::numeric_limits<T>::epsilon() };
+                        if (rng.below(10) == 0) return edges[rng.below(std::size(edges))];
+                        return static_cast<T>((rng.uniform() * 2 - 1) * static_cast<double>(size));
+                    },
+                    [](const T& value) { return shrink_number(value, T(0)); });
+            }
+        };
+
+        /**
+        * @brief strings and other containers of types that have a default generator
+        */
+        template<sequence T>
+            requires requires { arbitrary<typename T::value_type>::make(); }
+        struct arbitrary<T>
+        {
+            static gen<T> make()
+            {
+                return gen<T>::of(gen<typename T::value_type>());
+            }
+        };
+
+        /**
+        * @brief name of a property test, with where it was declared
+        */
+        struct property_name
+        {
+            template<class S>
+                requires std::convertible_to<S, std::string>
+            property_name(S&& str, std::source_location location = std::source_location::current())
+                : name(std::forward<S>(str)), where(location)
+            {
+            }
+
+            std::string name;
+            std::source_location where;
+        };
+
+        /**
+        * @class property_engine
+        * @brief checks a predicate on generated arguments. cases are made from the seed and their
+        * index alone, so they can run in any order on any thread the case runner spreads them 
+        * over (only idle ones, a parallel run never nests pools): workers take chunks of case
+        * indices and skip everything after the first failure found so far, which makes the 
+        * reported case the lowest failing index whatever the scheduling. that case is then 
+        * shrunk one argument at a time, as long as a smaller candidate still fails
+        */
+        template<class Predicate, class... T>
+        class property_engine
+        {
+        public:
+            static constexpr std::uint64_t chunk_size = 16;
+            static constexpr size_t max_size = 100;             // size hint cycles through [0, max_size]
+            static constexpr size_t max_shrink_tries = 10'000;  // predicate calls spent on shrinking
+
+            property_engine(std::tuple<gen<T>...> generators, Predicate pred, std::source_location location)
+                : gens(std::move(generators)), predicate(std::move(pred)), where(location)
+            {
+            }
+
+            void operator()(case_runner& runner)
+            {
+                const auto& ctx = runner.context();
+                std::uint64_t run_seed = ctx.seed ? ctx.seed : random_seed();
+                std::uint64_t seed = run_seed ^ test_hash(runner.suite(), runner.name());
+                std::uint64_t cases = ctx.property_cases;
+
+                std::atomic<std::uint64_t> next = 0,
+                    first_failed = std::numeric_limits<std::uint64_t>::max();
+                runner.spread([&]()
+                    {
+                        std::uint64_t done = 0, failed = 0;
+                        failure fail;
+                        while (true)
+                        {
+                            std::uint64_t start = next.fetch_add(chunk_size);
+                            if (start >= cases || start >= first_failed || runner.expired()) break;
+                            for (std::uint64_t i = start; i < std::min(start + chunk_size, cases) && i < first_failed; ++i)
+                            {
+                                ++done;
+                                if (holds(generate(seed, i), fail)) continue;
+                                ++failed;
+                                std::uint64_t known = first_failed;
+                                while (i < known && !first_failed.compare_exchange_weak(known, i)) {}
+                                break;
+                            }
+                        }
+                        runner.count(done, failed);
+                    });
+
+                if (first_failed < cases) report(runner, run_seed, first_failed, generate(seed, first_failed));
+            }
+
+        private:
+            using arguments = std::tuple<T...>;
+
+            /**
+            * @brief arguments of case index, the same for the same seed on every run
+            */
+            arguments generate(std::uint64_t seed, std::uint64_t index) const
+            {
+                std::uint64_t state = seed + index;
+                prng rng(splitmix64(state));
+                size_t size = static_cast<size_t>(index % (max_size + 1));
+                return std::apply([&](const auto&... g) { return arguments{ g(rng, size)... }; }, gens);
+            }
+
+            /**
+            * @brief whether the predicate holds for args. a failed check or exception is kept in fail,
+            * a predicate returning false leaves fail empty
+            */
+            bool holds(const arguments& args, failure& fail)
+            {
+                fail = {};
+                try
+                {
+                    using result = decltype(std::apply(predicate, args));
+                    if constexpr (std::is_void_v<result>)
+                    {
+                        std::apply(predicate, args);
+                        return true;
+                    }
+                    else
+                    {
+                        return static_cast<bool>(std::apply(predicate, args));
+                    }
+                }
+                catch (const test_fail& f)
+                {
+                    fail.check = f;
+                }
+                catch (const std::exception& e)
+                {
+                    fail.error = *e.what() ? e.what() : "unknown exception";
+                }
+                catch (...)
+                {
+                    fail.error = "unknown exception";
+                }
+                return false;
+            }
+
+            /**
+            * @brief shrink the failing arguments and report them as the failed case index
+            */
+            DOUGH_COLD void report(case_runner& runner, std::uint64_t run_seed, std::uint64_t index, arguments args)
+            {
+                failure fail;
+                holds(args, fail);
+
+                size_t shrinks = 0,
+                    tries = 0;
+                while (tries < max_shrink_tries && shrink_step(args, fail, tries, std::index_sequence_for<T...>{})) ++shrinks;
+
+                auto what = std::format("property does not hold with --seed={} ({} shrinks)", run_seed, shrinks);
+                auto value = sizeof...(T) == 1 ? value_format(std::get<0>(args)) : value_format(args);
+                if (fail.check)
+                {
+                    test_fail check = *fail.check;
+                    check.text = check.text.empty() ? what : std::format("{}: {}", what, check.text);
+                    runner.failed_case(index, value, &check, {});
+                }
+                else if (!fail.error.empty())
+                {
+                    runner.failed_case(index, value, nullptr, std::format("{}: {}", what, fail.error));
+                }
+                else
+                {
+                    test_fail check(what, "property", where, true, false);
+                    runner.failed_case(index, value, &check, {});
+                }
+            }
+
+            /**
+            * @brief replace one argument by the first of its shrink candidates that still fails, 
+            * false if none of them does
+            */
+            template<size_t... I>
+            bool shrink_step(arguments& args, failure& fail, size_t& tries, std::index_sequence<I...>)
+            {
+                auto shrink_one = [&]<size_t N>(std::integral_constant<size_t, N>)
+                    {
+                        for (auto& candidate : std::get<N>(gens).shrink(std::get<N>(args)))
+                        {
+                            if (++tries > max_shrink_tries) return false;
+                            arguments trial = args;
+                            std::get<N>(trial) = std::move(candidate);
+                            failure trial_fail;
+                            if (holds(trial, trial_fail)) continue;
+                            args = std::move(trial);
+                            fail = std::move(trial_fail);
+                            return true;
+                        }
+                        return false;
+                    };
+                return (shrink_one(std::integral_constant<size_t, I>{}) || ...);
+            }
+
+        private:
+            std::tuple<gen<T>...> gens;
+            Predicate predicate;
+            std::source_location where;
+        };
+
+        /**
+        * @struct case_access
+        * @brief lets test factories set the cases of a test
+        */
+        struct case_access
+        {
+            static void set(test& tst, small_function<void(case_runner&)> cases)
+            {
+                tst.cases = std::move(cases);
+            }
+        };
+    }
+
+    /**
+    * @brief make a property test: property("name", gen<A>(), gen<B>(), predicate) checks
+    * predicate(a, b) on options::property_cases generated cases, spread over the jobs. the 
+    * predicate fails by returning false or through a failed check. the first counterexample 
+    * is shrunk to a minimal one and reported with the seed that reproduces it (--seed)
+    */
+    template<class... Args>
+        requires (sizeof...(Args) >= 2)
+    test property(detail::property_name name, Args&&... args)
+    {
+        constexpr size_t count = sizeof...(Args) - 1;
+        auto all = std::forward_as_tuple(std::forward<Args>(args)...);
+        using predicate = std::decay_t<std::tuple_element_t<count, std::tuple<Args...>>>;
+
+        test tst(std::move(name.name));
+        [&]<size_t... I>(std::index_sequence<I...>)
+        {
+            using engine = detail::property_engine<predicate, typename std::decay_t<std::tuple_element_t<I, std::tuple<Args...>>>::value_type...>;
+            detail::case_access::set(tst, engine({ std::get<I>(all)... }, std::get<count>(all), name.where));
+        }(std::make_index_sequence<count>{});
+        return tst;
+    }
+
+    namespace detail
+    {
+        /**
+        * @brief file or directory name made of a test or suite name, 
+        * characters other than letters, digits, '-', '_' and '.' become '_'
+        */
+        inline std::string path_name(std::string_view name)
+        {
+            std::string result(name);
+            for (char& c : result)
+            {
+                if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.') c = '_';
+            }
+            return result.empty() || result == "." || result == ".." ? "_" : result;
+        }
+
+        /**
+        * @brief corpus directory of a fuzz test
+        */
+        inline std::filesystem::path fuzz_directory(std::string_view corpus, std::string_view suite_name, std::string_view test_name)
+        {
+            return std::filesystem::path(corpus) / path_name(suite_name) / path_name(test_name);
+        }
+
+        /**
+        * @brief whole file as bytes
+        */
+        inline std::vector<std::uint8_t> file_bytes(const std::filesystem::path& path)
+        {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) throw std::runtime_error(std::format("cannot read '{}'", path.string()));
+            std::vector<std::uint8_t> bytes(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            return bytes;
+        }
+
+        /**
+        * @brief save a failing input as a regression case of the fuzz test corpus in directory, 
+        * named by its hash so the same input is saved once. path of the file, empty on failure
+        */
+        inline std::filesystem::path fuzz_save(const std::filesystem::path& directory, std::span<const std::uint8_t> data)
+        {
+            std::error_code ec;
+            auto regressions = directory / "regressions";
+            std::filesystem::create_directories(regressions, ec);
+            auto path = regressions / id_format(fnv1a(std::string_view(reinterpret_cast<const char*>(data.data()), data.size())));
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if (!file) return {};
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            return file ? path : std::filesystem::path();
+        }
+
+        /**
+        * @class fuzz_engine
+        * @brief replays the corpus of a fuzz test, one case per file found under 
+        * <corpus>/<suite>/<test>, regressions included. files are listed lazily and 
+        * read by the thread running the case. without a corpus the empty input is run
+        */
+        template<class F>
+        class fuzz_engine
+        {
+        public:
+            explicit fuzz_engine(F func) : body(std::move(func)) {}
+
+            void operator()(case_runner& runner)
+            {
+                auto replay = [&](const std::filesystem::path& file)
+                    {
+                        if (file.empty())
+                        {
+                            body(std::span<const std::uint8_t>());
+                            return;
+                        }
+                        auto bytes = file_bytes(file);
+                        body(std::span<const std::uint8_t>(bytes));
+                    };
+
+                std::error_code ec;
+                auto directory = fuzz_directory(runner.context().corpus, runner.suite(), runner.name());
+                std::filesystem::recursive_directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, ec);
+                if (ec)
+                {
+                    auto empty = std::views::single(std::filesystem::path());
+                    runner.run(empty, replay);
+                    return;
+                }
+
+                auto files = std::ranges::subrange(std::move(it), std::filesystem::recursive_directory_iterator()) |
+                    std::views::filter([](const std::filesystem::directory_entry& entry) { return entry.is_regular_file(); }) |
+                    std::views::transform([](const std::filesystem::directory_entry& entry) { return entry.path(); });
+                runner.run(files, replay);
+            }
+
+        private:
+            F body;
+        };
+    }
+
+    /**
+    * @brief make a fuzz test: body gets the bytes of one input as std::span<const std::uint8_t>.
+    * runs replay every file under <corpus>/<suite>/<test> (options::corpus, --corpus) as a case,
+    * spread over the jobs; with no corpus yet the empty input is run. failing inputs found by 
+    * the fuzzer are saved to its regressions directory, so later runs replay them. to fuzz, 
+    * define the test with DOUGH_FUZZ_TEST, the fuzzer's main does not run registry code
+    */
+    template<class F>
+        requires std::invocable<F&, std::span<const std::uint8_t>>
+    test fuzz_test(std::string name, F&& body)
+    {
+        test tst(std::move(name));
+        detail::case_access::set(tst, detail::fuzz_engine<std::decay_t<F>>(std::forward<F>(body)));
+        return tst;
+    }
+
+    /**
+    * @brief keeps the compiler from optimizing away a value computed in a benchmark
+    */
+    template<class T>
+    inline void do_not_optimize(const T& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "m"(value) : "memory");
+#else
+        detail::bench_sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+    * @brief keeps the compiler from optimizing away a value computed in a benchmark,
+    * and from assuming it is unchanged afterwards
+    */
+    template<class T>
+    inline void do_not_optimize(T& value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : "+m"(value) : : "memory");
+#else
+        detail::bench_sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+    * @brief forces pending memory writes to be treated as observable
+    */
+    inline void clobber_memory() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+    * @struct bench_result
+    * @brief measurements of one benchmark, times are per iteration in nanoseconds
+    */
+    struct bench_result
+    {
+        std::string name;
+        std::vector<double> samples;                                // time per iteration of each sample
+        std::vector<double> cpu_samples;                            // cpu time per iteration of each sample, paused time included
+        std::vector<std::pair<std::string, double>> counters;       // user counters, last value set
+        size_t iterations = 0;                                      // iterations per sample
+        double mean = 0,
+            median = 0,
+            stddev = 0,
+            min = 0;
+        double bytes = 0,                                           // bytes processed per iteration
+            items = 0;                                              // items processed per iteration
+    };
+
+    namespace detail
+    {
+        /**
+        * @brief compute mean, median, sample standard deviation and min of the samples
+        */
+        inline void bench_stats(bench_result& result)
+        {
+            auto& samples = result.samples;
+            if (samples.empty()) return;
+
+            std::vector<double> sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            size_t n = sorted.size();
+
+            result.min = sorted.front();
+            result.median = (n % 2 == 1) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+            result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(n);
+
+            double squares = 0;
+            for (double x : sorted) squares += (x - result.mean) * (x - result.mean);
+            result.stddev = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+        }
+
+        /**
+        * @brief escape string for a json string literal
+        */
+        inline std::string json_escape(std::string_view str)
+        {
+            std::string result;
+            result.reserve(str.size());
+            for (char c : str)
+            {
+                switch (c)
+                {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) result += std::format("\\u{:04x}", static_cast<int>(c));
+                    else result += c;
+                }
+            }
+            return result;
+        }
+
+        /**
+        * @struct json
+        * @brief parsed json value, just enough to read benchmark baselines
+        */
+        struct json
+        {
+            enum class kind { null, boolean, number, string, array, object };
+
+            kind type = kind::null;
+            bool boolean = false;
+            double number = 0;
+            std::string string;
+            std::vector<json> items;            // array elements or object values
+            std::vector<std::string> keys;      // object keys, parallel to items
+
+            /**
+            * @brief get object member, nullptr if missing
+            */
+            const json* find(std::string_view key) const
+            {
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    if (keys[i] == key) return &items[i];
+                }
+                return nullptr;
+            }
+
+            /**
+            * @brief parse a whole document, nullopt on malformed input
+            */
+            static std::optional<json> parse(std::string_view text)
+            {
+                size_t pos = 0;
+                json value;
+                if (!parse_value(text, pos, value, 0)) return std::nullopt;
+                skip_space(text, pos);
+                if (pos != text.size()) return std::nullopt;
+                return value;
+            }
+
+        private:
+            static void skip_space(std::string_view text, size_t& pos)
+            {
+                while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+            }
+
+            static bool parse_string(std::string_view text, size_t& pos, std::string& out)
+            {
+                if (pos >= text.size() || text[pos] != '"') return false;
+                ++pos;
+                while (pos < text.size() && text[pos] != '"')
+                {
+                    char c = text[pos++];
+                    if (c != '\\')
+                    {
+                        out += c;
+                        continue;
+                    }
+                    if (pos >= text.size()) return false;
+                    char e = text[pos++];
+                    switch (e)
+                    {
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u':
+                    {
+                        // names are compared as is, so non-ascii escapes are kept as '?'
+                        unsigned code = 0;
+                        if (pos + 4 > text.size()) return false;
+                        auto [end, ec] = std::from_chars(text.data() + pos, text.data() + pos + 4, code, 16);
+                        if (ec != std::errc() || end != text.data() + pos + 4) return false;
+                        out += code < 0x80 ? static_cast<char>(code) : '?';
+                        pos += 4;
+                        break;
+                    }
+                    default: out += e;
+                    }
+                }
+                if (pos >= text.size()) return false;
+                ++pos;
+                return true;
+            }
+
+            static bool parse_value(std::string_view text, size_t& pos, json& out, int depth)
+            {
+                if (depth > 64) return false;
+                skip_space(text, pos);
+                if (pos >= text.size()) return false;
+
+                char c = text[pos];
+                if (c == '{' || c == '[')
+                {
+                    bool object = (c == '{');
+                    out.type = object ? kind::object : kind::array;
+                    ++pos;
+                    skip_space(text, pos);
+                    if (pos < text.size() && text[pos] == (object ? '}' : ']'))
+                    {
+                        ++pos;
+                        return true;
+                    }
+                    while (true)
+                    {
+                        if (object)
+                        {
+                            skip_space(text, pos);
+                            if (!parse_string(text, pos, out.keys.emplace_back())) return false;
+                            skip_space(text, pos);
+                            if (pos >= text.size() || text[pos++] != ':') return false;
+                        }
+                        if (!parse_value(text, pos, out.items.emplace_back(), depth + 1)) return false;
+                        skip_space(text, pos);
+                        if (pos >= text.size()) return false;
+                        if (text[pos] == ',')
+                        {
+                            ++pos;
+                            continue;
+                        }
+                        if (text[pos++] != (object ? '}' : ']')) return false;
+                        return true;
+                    }
+                }
+                if (c == '"')
+                {
+                    out.type = kind::string;
+                    return parse_string(text, pos, out.string);
+                }
+                for (auto [word, type, value] : { std::tuple{ "true", kind::boolean, true },
+                    std::tuple{ "false", kind::boolean, false }, std::tuple{ "null", kind::null, false } })
+                {
+                    if (text.substr(pos).starts_with(word))
+                    {
+                        out.type = type;
+                        out.boolean = value;
+                        pos += std::string_view(word).size();
+                        return true;
+                    }
+                }
+
+                // from_chars does not accept a leading '+', json does not allow it either
+                auto [end, ec] = std::from_chars(text.data() + pos, text.data() + text.size(), out.number);
+                if (ec != std::errc()) return false;
+                out.type = kind::number;
+                pos = static_cast<size_t>(end - text.data());
+                return true;
+            }
+        };
+
+        /**
+        * @brief write benchmark results in google-benchmark's json format, one 'iteration'
+        * entry per sample (as repetitions) followed by mean, median and stddev aggregates
+        */
+        inline void baseline_write(
+            std::ostream& out,
+            const std::vector<std::pair<std::string, const bench_result*>>& results)
+        {
+            char date[32] = {};
+            std::time_t now = std::time(nullptr);
+            if (const std::tm* local = std::localtime(&now))
+            {
+                std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", local);
+            }
+
+            out << "{\n"
+                "  \"context\": {\n"
+                "    \"date\": \"" << date << "\",\n"
+                "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+                "    \"library_build_type\": \"release\",\n"
+#else
+                "    \"library_build_type\": \"debug\",\n"
+#endif
+                "    \"library\": \"dough\"\n"
+                "  },\n"
+                "  \"benchmarks\": [";
+
+            bool first = true;
+            auto entry = [&](const std::string& name, const bench_result& result, size_t family,
+                const char* aggregate, size_t index, double real, double cpu)
+                {
+                    out << (first ? "\n" : ",\n") << "    {\n";
+                    first = false;
+
+                    std::string run_name = json_escape(name);
+                    out << "      \"name\": \"" << run_name << (aggregate ? std::format("_{}", aggregate) : "") << "\",\n" <<
+                        "      \"family_index\": " << family << ",\n" <<
+                        "      \"per_family_instance_index\": 0,\n" <<
+                        "      \"run_name\": \"" << run_name << "\",\n" <<
+                        "      \"run_type\": \"" << (aggregate ? "aggregate" : "iteration") << "\",\n" <<
+                        "      \"repetitions\": " << result.samples.size() << ",\n";
+                    if (aggregate)
+                    {
+                        out << "      \"threads\": 1,\n" <<
+                            "      \"aggregate_name\": \"" << aggregate << "\",\n" <<
+                            "      \"aggregate_unit\": \"time\",\n" <<
+                            "      \"iterations\": " << result.samples.size() << ",\n";
+                    }
+                    else
+                    {
+                        out << "      \"repetition_index\": " << index << ",\n" <<
+                            "      \"threads\": 1,\n" <<
+                            "      \"iterations\": " << result.iterations << ",\n";
+                    }
+                    out << std::format("      \"real_time\": {},\n", real) <<
+                        std::format("      \"cpu_time\": {},\n", cpu) <<
+                        "      \"time_unit\": \"ns\"";
+                    if (!aggregate && result.bytes > 0 && real > 0)
+                    {
+                        out << std::format(",\n      \"bytes_per_second\": {}", result.bytes / real * 1e9);
+                    }
+                    if (!aggregate && result.items > 0 && real > 0)
+                    {
+                        out << std::format(",\n      \"items_per_second\": {}", result.items / real * 1e9);
+                    }
+                    if (!aggregate)
+                    {
+                        for (const auto& [counter, value] : result.counters)
+                        {
+                            out << ",\n      \"" << json_escape(counter) << "\": " << std::format("{}", value);
+                        }
+                    }
+                    out << "\n    }";
+                };
+
+            for (size_t family = 0; family < results.size(); ++family)
+            {
+                const auto& [name, result] = results[family];
+                for (size_t i = 0; i < result->samples.size(); ++i)
+                {
+                    double cpu = i < result->cpu_samples.size() ? result->cpu_samples[i] : result->samples[i];
+                    entry(name, *result, family, nullptr, i, result->samples[i], cpu);
+                }
+
+                bench_result cpu_stats;
+                cpu_stats.samples = result->cpu_samples;
+                bench_stats(cpu_stats);
+                entry(name, *result, family, "mean", 0, result->mean, cpu_stats.mean);
+                entry(name, *result, family, "median", 0, result->median, cpu_stats.median);
+                entry(name, *result, family, "stddev", 0, result->stddev, cpu_stats.stddev);
+            }
+            out << "\n  ]\n}\n";
+        }
+
+        /**
+        * @brief read per-iteration real time samples (in ns) from a google-benchmark json file,
+        * keyed by run name. only 'iteration' entries are used, aggregates are skipped
+        */
+        inline std::optional<std::unordered_map<std::string, std::vector<double>>> baseline_read(const std::string& path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return std::nullopt;
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            auto doc = json::parse(text);
+            if (!doc) return std::nullopt;
+            const json* benchmarks = doc->find("benchmarks");
+            if (!benchmarks || benchmarks->type != json::kind::array) return std::nullopt;
+
+            std::unordered_map<std::string, std::vector<double>> samples;
+            for (const auto& entry : benchmarks->items)
+            {
+                const json* run_type = entry.find("run_type");
+                if (run_type && run_type->string != "iteration") continue;
+
+                const json* name = entry.find("run_name");
+                if (!name) name = entry.find("name");
+                const json* real = entry.find("real_time");
+                if (!name || !real || real->type != json::kind::number) continue;
+
+                double scale = 1;
+                if (const json* unit = entry.find("time_unit"))
+                {
+                    if (unit->string == "us") scale = 1e3;
+                    else if (unit->string == "ms") scale = 1e6;
+                    else if (unit->string == "s") scale = 1e9;
+                }
+                samples[name->string].push_back(real->number * scale);
+            }
+            return samples;
+        }
+
+        /**
+        * @brief one-sided mann-whitney u test: p-value of 'current' being stochastically
+        * greater (slower) than 'base'. normal approximation with tie and continuity correction
+        */
+        inline double mann_whitney_p(const std::vector<double>& base, const std::vector<double>& current)
+        {
+            size_t n1 = base.size(),
+                n2 = current.size(),
+                n = n1 + n2;
+            if (n1 == 0 || n2 == 0) return 1.0;
+
+            // pool, rank with averaged ties
+            std::vector<std::pair<double, bool>> pooled; // value, is from current
+            for (double x : base) pooled.emplace_back(x, false);
+            for (double x : current) pooled.emplace_back(x, true);
+            std::sort(pooled.begin(), pooled.end());
+
+            double rank_sum = 0,
+                tie_term = 0;
+            for (size_t i = 0; i < n;)
+            {
+                size_t j = i;
+                while (j < n && pooled[j].first == pooled[i].first) ++j;
+                double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2;
+                for (size_t k = i; k < j; ++k)
+                {
+                    if (pooled[k].second) rank_sum += rank;
+                }
+                double t = static_cast<double>(j - i);
+                tie_term += t * t * t - t;
+                i = j;
+            }
+
+            double u = rank_sum - static_cast<double>(n2 * (n2 + 1)) / 2;
+            double mean = static_cast<double>(n1 * n2) / 2;
+            double variance = static_cast<double>(n1 * n2) / 12 *
+                (static_cast<double>(n + 1) - tie_term / static_cast<double>(n * (n - 1)));
+            if (variance <= 0) return 1.0;
+
+            double z = (u - mean - 0.5) / std::sqrt(variance);
+            return 0.5 * std::erfc(z / std::sqrt(2.0));
+        }
+    }
+
+    /**
+    * @class bench_state
+    * @brief passed to benchmark functions, drives the timed loop:
+    * for (auto _ : state) { ... }
+    */
+    class bench_state
+    {
+        friend class bench;
+
+    public:
+        /**
+        * @struct iterator
+        * @brief counts down the iterations of one sample, stops the timer at the end
+        */
+        struct iterator
+        {
+            struct value
+            {
+                ~value() {} // non-trivial, so 'for (auto _ : state)' does not warn as unused
+            };
+
+            bench_state* state = nullptr;
+            size_t remaining = 0;
+
+            value operator*() const noexcept { return {}; }
+            iterator& operator++() noexcept
+            {
+                --remaining;
+                return *this;
+            }
+            bool operator!=(const iterator&) const noexcept
+            {
+                if (remaining != 0) return true;
+                state->pause();
+                return false;
+            }
+        };
+
+        /**
+        * @brief start the timed loop
+        */
+        iterator begin() noexcept
+        {
+            resume();
+            return { this, iteration_count };
+        }
+
+        /**
+        * @brief end of the timed loop
+        */
+        iterator end() noexcept
+        {
+            return { this, 0 };
+        }
+
+        /**
+        * @brief iterations in the current sample
+        */
+        size_t iterations() const noexcept
+        {
+            return iteration_count;
+        }
+
+        /**
+        * @brief stop the timer, e.g. for per-iteration setup
+        */
+        void pause() noexcept
+        {
+            if (!running) return;
+            elapsed += std::chrono::steady_clock::now() - started;
+            running = false;
+        }
+
+        /**
+        * @brief restart the timer after pause()
+        */
+        void resume() noexcept
+        {
+            if (running) return;
+            started = std::chrono::steady_clock::now();
+            running = true;
+        }
+
+        /**
+        * @brief set bytes processed per iteration, reported as GB/s
+        */
+        bench_state& bytes(double per_iteration) noexcept
+        {
+            bytes_count = per_iteration;
+            return *this;
+        }
+
+        /**
+        * @brief set items processed per iteration, reported as items/s
+        */
+        bench_state& items(double per_iteration) noexcept
+        {
+            items_count = per_iteration;
+            return *this;
+        }
+
+        /**
+        * @brief set a named user counter, reported as is
+        */
+        bench_state& counter(const std::string& name, double value)
+        {
+            auto it = std::find_if(counter_list.begin(), counter_list.end(),
+                [&](const auto& entry) { return entry.first == name; });
+            if (it != counter_list.end()) it->second = value;
+            else counter_list.emplace_back(name, value);
+            return *this;
+        }
+
+    private:
+        explicit bench_state(size_t iterations) noexcept : iteration_count(iterations) {}
+
+    private:
+        std::vector<std::pair<std::string, double>> counter_list;
+        std::chrono::steady_clock::duration elapsed{};
+        std::chrono::steady_clock::time_point started;
+        size_t iteration_count = 0;
+        double bytes_count = 0,
+            items_count = 0;
+        bool running = false;
+    };
+
+    /**
+    * @class bench
+    * @brief represents a single micro-benchmark. registered into suites like tests,
+    * runs only in benchmark mode (--bench)
+    */
+    class bench
+    {
+        friend class suite;
+
+    public:
+        bench(std::string name) noexcept : bench_name(std::move(name)) {}
+        bench(const bench& src) = default;
+        bench(bench&& src) noexcept = default;
+        bench& operator=(const bench& src) = default;
+        bench& operator=(bench&& src) noexcept = default;
+
+        /**
+        * @brief set benchmark function that runs the timed loop itself
+        */
+        bench& func(detail::small_function<void(bench_state&)> bench_func) noexcept
+        {
+            if (bench_func) function = std::move(bench_func);
+            return *this;
+        }
+
+        /**
+        * @brief set benchmark function that is called once per iteration
+        */
+        bench& func(detail::small_function<void()> bench_func) noexcept
+        {
+            if (bench_func)
+            {
+                function = [f = std::move(bench_func)](bench_state& state)
+                    {
+                        for (auto _ : state) f();
+                    };
+            }
+            return *this;
+        }
+
+        /**
+        * @brief add benchmark tags
+        */
+        template<typename First, typename... Rest>
+            requires
+        (std::convertible_to<First, std::string> &&
+        (std::convertible_to<Rest, std::string> && ...))
+            bench& tags(First&& first, Rest&&... rest) noexcept
+        {
+            detail::tags_insert(tag_set, std::forward<First>(first), std::forward<Rest>(rest)...);
+            return *this;
+        }
+
+        /**
+        * @brief get tag names, own and inherited from the suite, sorted
+        */
+        std::vector<std::string_view> tags() const
+        {
+            if (!inherited) return detail::tags_names(tag_set);
+            detail::tag_set all = *inherited;
+            all |= tag_set;
+            return detail::tags_names(all);
+        }
+
+        /**
+        * @brief set minimum time of one sample, the iteration count is calibrated to reach it
+        */
+        bench& min_time(std::chrono::nanoseconds time) noexcept
+        {
+            sample_time = time;
+            return *this;
+        }
+
+        /**
+        * @brief set time to run the benchmark before measuring
+        */
+        bench& warmup(std::chrono::nanoseconds time) noexcept
+        {
+            warmup_time = time;
+            return *this;
+        }
+
+        /**
+        * @brief set number of samples to collect
+        */
+        bench& samples(size_t count) noexcept
+        {
+            if (count > 0) sample_count = count;
+            return *this;
+        }
+
+        /**
+        * @brief set name
+        */
+        bench& name(std::string new_name) noexcept
+        {
+            bench_name = std::move(new_name);
+            return *this;
+        }
+
+        /**
+        * @brief get name
+        */
+        const std::string& name() const noexcept
+        {
+            return bench_name;
+        }
+
+        /**
+        * @brief run the benchmark
+        */
+        bool run()
+        {
+            bench_result result;
+            detail::outcome outcome;
+            detail::failure fail;
+            auto& rep = detail::console();
+            rep.on_bench_start(owner_name, bench_name);
+            run(result, outcome, fail);
+
+            bench_report report(owner_name, bench_name, outcome, fail);
+            if (outcome.passed) report.result = &result;
+            rep.on_bench_end(report);
+            return outcome.passed;
+        }
+
+    private:
+        /**
+        * @brief set owner suite
+        */
+        void owner(const std::string& name) noexcept
+        {
+            owner_name = name;
+        }
+
+        /**
+        * @brief run one sample of the given number of iterations, returns its timed duration
+        */
+        std::chrono::nanoseconds sample(size_t iterations, bench_result& result, std::chrono::nanoseconds* cpu = nullptr)
+        {
+            bench_state state(iterations);
+            auto cpu_start = detail::thread_cpu_time();
+            function(state);
+            state.pause();
+            if (cpu) *cpu = detail::thread_cpu_time() - cpu_start;
+
+            result.bytes = state.bytes_count;
+            result.items = state.items_count;
+            result.counters = std::move(state.counter_list);
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(state.elapsed);
+        }
+
+        /**
+        * @brief calibrate, warm up and measure. a failed check or exception is kept in fail,
+        * reporting is up to the caller. with perf, hardware counters of the measured samples 
+        * are added to the counters per iteration
+        */
+        void run(bench_result& result, detail::outcome& outcome, detail::failure& fail, bool perf = false)
+        {
+            if (!function) return;
+
+            auto wall_start = std::chrono::steady_clock::now();
+            auto cpu_start = detail::thread_cpu_time();
+            auto stop = [&]()
+                {
+                    outcome.wall = detail::since(wall_start);
+                    outcome.cpu = detail::thread_cpu_time() - cpu_start;
+                };
+
+            try
+            {
+                // grow the iteration count until one sample takes min_time, this doubles as warmup
+                size_t iterations = 1;
+                auto warmed = std::chrono::nanoseconds(0);
+                while (true)
+                {
+                    auto time = sample(iterations, result);
+                    warmed += time;
+                    if (time >= sample_time || iterations >= max_iterations) break;
+
+                    // aim a bit past min_time, but grow at most 10x per step
+                    double ratio = time.count() > 0 ? 1.2 * sample_time.count() / time.count() : 10.0;
+                    iterations = static_cast<size_t>(iterations * std::clamp(ratio, 2.0, 10.0));
+                }
+                while (warmed < warmup_time)
+                {
+                    warmed += sample(iterations, result);
+                }
+
+                result.name = bench_name;
+                result.iterations = iterations;
+                result.samples.clear();
+                result.cpu_samples.clear();
+                detail::perf_scope counters(perf);
+                for (size_t i = 0; i < sample_count; ++i)
+                {
+                    std::chrono::nanoseconds cpu{};
+                    auto time = sample(iterations, result, &cpu);
+                    result.samples.push_back(static_cast<double>(time.count()) / static_cast<double>(iterations));
+                    result.cpu_samples.push_back(static_cast<double>(cpu.count()) / static_cast<double>(iterations));
+                }
+                outcome.perf = counters.stop();
+                detail::bench_stats(result);
+
+                // paused time is counted too, like the cpu samples
+                constexpr std::array<const char*, detail::perf_usage::event_count> names{ "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses" };
+                auto runs = static_cast<double>(iterations * sample_count);
+                for (unsigned e = 0; e < names.size(); ++e)
+                {
+                    if (!outcome.perf.counted(static_cast<detail::perf_usage::event>(e))) continue;
+                    result.counters.emplace_back(names[e], static_cast<double>(outcome.perf.counts[e]) / runs);
+                }
+                if (outcome.perf.ipc() > 0) result.counters.emplace_back("IPC", outcome.perf.ipc());
+
+                stop();
+                outcome.passed = true;
+            }
+            catch (const detail::test_fail& f)
+            {
+                stop();
+                fail.check = f;
+            }
+            catch (const std::exception& e)
+            {
+                stop();
+                fail.error = *e.what() ? e.what() : "unknown exception";
+            }
+            catch (...)
+            {
+                stop();
+                fail.error = "unknown exception";
+            }
+        }
+
+    private:
+        detail::tag_set tag_set;                                // own tags
+        std::shared_ptr<const detail::tag_set> inherited;       // tags of the owner suite
+        detail::small_function<void(bench_state&)> function;
+        std::string bench_name;
+        std::string owner_name;
+        std::chrono::nanoseconds sample_time = std::chrono::milliseconds(10);
+        std::chrono::nanoseconds warmup_time = std::chrono::milliseconds(50);
+        size_t sample_count = 10;
+
+        static constexpr size_t max_iterations = size_t(1) << 40; // stops calibration if the loop is never timed
+    };
+
+    /**
+    * @struct suite_stats
+    * @brief holds stats for a suite run
+    */
+    struct suite_stats
+    {
+        /**
+        * @struct timing
+        * @brief measured times of a single test
+        */
+        struct timing
+        {
+            std::string name;
+            detail::outcome result;
+        };
+
+        std::vector<std::string> failed;
+        std::vector<std::string> cancelled;     // tests not run because the run stopped early, see options::fail_fast
+        std::vector<timing> times;              // every test, in run order
+        std::vector<bench_result> benches;      // every benchmark that finished, in run order
+        std::chrono::nanoseconds wall{},        // sum of test function wall times
+            cpu{},                              // sum of test function cpu times
+            setup{},                            // sum of setup times
+            teardown{},                         // sum of teardown times
+            fixture_setup{},                    // setup_once and fixtures, see suite::fixture()
+            fixture_teardown{};                 // fixtures and teardown_once, not measured in isolated workers
+        detail::alloc_usage memory;             // heap usage summed over the tests, with the highest peak
+        detail::perf_usage perf;                // counters and rusage summed over the tests and benchmarks, see options::perf
+        int run = 0,
+            pass = 0,
+            fail = 0;
+
+        /**
+        * @brief count a finished test
+        */
+        void add(const std::string& name, const detail::outcome& result)
+        {
+            if (result.passed) pass++;
+            else
+            {
+                fail++;
+                failed.push_back(name);
+            }
+            run++;
+
+            wall += result.wall;
+            cpu += result.cpu;
+            setup += result.setup;
+            teardown += result.teardown;
+            fixture_setup += result.fixture_setup;
+            memory += result.memory;
+            perf += result.perf;
+            times.push_back({ name, result });
+        }
+
+        /**
+        * @brief get the test with the longest wall time, nullptr if nothing ran
+        */
+        const timing* slowest() const noexcept
+        {
+            auto it = std::max_element(times.begin(), times.end(),
+                [](const timing& a, const timing& b) { return a.result.wall < b.result.wall; });
+            return it == times.end() ? nullptr : &*it;
+        }
+    };
+
+    /**
+    * @struct run_summary
+    * @brief whole run summary
+    */
+    struct run_summary
+    {
+        std::vector<std::pair<std::string, suite_stats>> stats; // in registration order
+        std::chrono::nanoseconds wall{};                        // whole run, wall clock
+    };
+
+    namespace detail
+    {
+        /**
+        * @struct suite_fixture
+        * @brief once per suite hooks and the fixture of a suite, see suite::setup_once() and suite::fixture()
+        */
+        struct suite_fixture
+        {
+            small_function<void()> setup;
+            small_function<void()> teardown;
+            const std::type_info* type = nullptr;
+            small_function<std::shared_ptr<void>()> make;
+
+            bool empty() const noexcept
+            {
+                return !setup && !teardown && !make;
+            }
+        };
+
+        /**
+        * @class suite_session
+        * @brief a suite during one run: the first test to start runs setup_once, each thread makes 
+        * its own fixture before its first test of the suite, the last test to finish destroys the 
+        * fixtures and runs teardown_once. tests of a suite may run on several threads at once, 
+        * unless it is suite::serial()
+        */
+        class suite_session
+        {
+        public:
+            suite_session(const std::string& suite_name, const suite_fixture& hooks, size_t tests)
+                : suite_name(suite_name), hooks(hooks), remaining(tests) {}
+
+            /**
+            * @brief before a test: set the suite up if nothing did yet, make the fixture of this thread 
+            * if it has none. returns the time spent. an error goes into fail, the test must not run then
+            */
+            std::chrono::nanoseconds enter(failure& fail)
+            {
+                current_fixture = {};
+                if (hooks.empty()) return {};
+
+                auto start = std::chrono::steady_clock::now();
+                std::string failed;
+                std::shared_ptr<void> object;
+                {
+                    // tests of the suite on other threads wait until setup_once is done
+                    std::lock_guard lock(mutex);
+                    if (!set_up)
+                    {
+                        set_up = true;
+                        if (hooks.setup) error = attempt("setup_once", [&]() { hooks.setup(); });
+                    }
+                    failed = error;
+                    if (auto it = fixtures.find(std::this_thread::get_id()); it != fixtures.end()) object = it->second;
+                }
+
+                // fixtures of different threads are made at the same time
+                if (failed.empty() && !object && hooks.make)
+                {
+                    failed = attempt("fixture", [&]() { object = hooks.make(); });
+                    std::lock_guard lock(mutex);
+                    if (failed.empty()) fixtures.emplace(std::this_thread::get_id(), object);
+                    else if (error.empty()) error = failed;
+                }
+
+                if (!failed.empty()) fail.error = std::move(failed);
+                else if (object) current_fixture = { hooks.type, object.get() };
+                return since(start);
+            }
+
+            /**
+            * @brief after a test, the last one of the suite tears it down
+            */
+            void leave()
+            {
+                current_fixture = {};
+                if (hooks.empty()) return;
+                {
+                    std::lock_guard lock(mutex);
+                    if (--remaining > 0) return;
+                }
+                finish();
+            }
+
+            /**
+            * @brief tear the suite down if it was set up in this process and is not torn down yet, 
+            * for runs that stopped early and isolated workers. returns the time tearing down took. 
+            * teardown_once is skipped after a setup_once that threw
+            */
+            std::chrono::nanoseconds finish()
+            {
+                std::lock_guard lock(mutex);
+                if (!set_up || torn_down) return teardown_time;
+                torn_down = true;
+
+                auto start = std::chrono::steady_clock::now();
+                fixtures.clear();
+                if (hooks.teardown && !error.starts_with("setup_once"))
+                {
+                    auto failed = attempt("teardown_once", [&]() { hooks.teardown(); });
+                    if (!failed.empty()) print_error(std::format("[DOUGH] Error: suite '{}' {}\n", suite_name, failed));
+                }
+                teardown_time = since(start);
+                return teardown_time;
+            }
+
+        private:
+            /**
+            * @brief call a hook, the message of what it threw or an empty string
+            */
+            template<class F>
+            static std::string attempt(std::string_view hook, F&& body)
+            {
+                try
+                {
+                    body();
+                    return {};
+                }
+                catch (const std::exception& e)
+                {
+                    return std::format("{} failed: {}", hook, *e.what() ? e.what() : "unknown exception");
+                }
+                catch (...)
+                {
+                    return std::format("{} failed: unknown exception", hook);
+                }
+            }
+
+        private:
+            const std::string& suite_name;
+            const suite_fixture& hooks;
+            std::mutex mutex;
+            bool set_up = false,
+                torn_down = false;
+            std::string error;                  // of setup_once or a fixture, fails the remaining tests
+            std::unordered_map<std::thread::id, std::shared_ptr<void>> fixtures;
+            size_t remaining;                   // tests left to finish
+            std::chrono::nanoseconds teardown_time{};
+        };
+    }
+
+    /**
+    * @class suite
+    * @brief test suite class
+    */
+    class suite
+    {
+        friend test;
+        friend class registry;
+
+    public:
+        using stats = suite_stats;
+
+        suite(std::string name) noexcept : suite_name(std::move(name)) {}
+        suite(suite&& src) noexcept = default;
+        suite& operator=(suite&& src) noexcept = default;
+
+        /**
+        * @brief copy, the copied tests and benchmarks inherit the tags of the copy
+        */
+        suite(const suite& src)
+            : tag_set(std::make_shared<detail::tag_set>(*src.tag_set)),
+            setup_function(src.setup_function),
+            teardown_function(src.teardown_function),
+            once(src.once),
+            parallel_tests(src.parallel_tests),
+            suite_name(src.suite_name),
+            test_list(src.test_list),
+            bench_list(src.bench_list)
+        {
+            for (size_t i = 0; i < test_list.size(); ++i)
+            {
+                test_list[i].inherited = tag_set;
+                test_index.try_emplace(test_list[i].name(), i);
+            }
+            for (auto& bch : bench_list) bch.inherited = tag_set;
+        }
+
+        suite& operator=(const suite& src)
+        {
+            if (this != &src) *this = suite(src);
+            return *this;
+        }
+
+        /**
+        * @brief add setup function that will run before each test
+        */
+        suite& setup(detail::small_function<void()> setup_func)
+        {
+            if (setup_func) setup_function = std::move(setup_func);
+            return *this;
+        }
+
+        /**
+        * @brief add teardown function that will run after each test
+        */
+        suite& teardown(detail::small_function<void()> teardown_func)
+        {
+            if (teardown_func) teardown_function = std::move(teardown_func);
+            return *this;
+        }
+
+        /**
+        * @brief let the tests of a suite with setup or teardown run on several workers at once, 
+        * which needs those to be thread-safe. by default they run one after another on one worker, 
+        * so no test runs between another one and its teardown
+        */
+        suite& parallel(bool enabled = true) noexcept
+        {
+            parallel_tests = enabled;
+            return *this;
+        }
+
+        /**
+        * @brief add setup function that runs once, before the first test of the suite that runs. 
+        * with process isolation it runs once per worker process. if it throws, the tests of the suite fail
+        */
+        suite& setup_once(detail::small_function<void()> setup_func)
+        {
+            if (setup_func) once.setup = std::move(setup_func);
+            return *this;
+        }
+
+        /**
+        * @brief add teardown function that runs once, after the last test of the suite. 
+        * isolated workers run it when they exit, but not after a crash
+        */
+        suite& teardown_once(detail::small_function<void()> teardown_func)
+        {
+            if (teardown_func) once.teardown = std::move(teardown_func);
+            return *this;
+        }
+
+        /**
+        * @brief give the tests of the suite a Fixture, made from copies of args before the first test 
+        * (after setup_once) and destroyed after the last one (before teardown_once). tests taking 
+        * a Fixture& get it, e.g. test("query").func([](database& db) { ... }). in parallel runs 
+        * each worker thread makes its own, so tests never share one at the same time
+        */
+        template<class Fixture, class... Args>
+            requires std::constructible_from<Fixture, std::decay_t<Args>&...>
+        suite& fixture(Args&&... args)
+        {
+            once.type = &typeid(Fixture);
+            once.make = [... values = std::forward<Args>(args)]() -> std::shared_ptr<void>
+                {
+                    return std::make_shared<Fixture>(values...);
+                };
+            return *this;
+        }
+
+        /**
+        * @brief add suite tags. these are inherited by all test in a suite
+        */
+        template<typename First, typename... Rest>
+            requires 
+        (std::convertible_to<First, std::string> &&
+        (std::convertible_to<Rest, std::string> && ...))
+            suite& tags(First&& first, Rest&&... rest) noexcept
+        {
+            // tests reference this set, so they see tags added after them too
+            detail::tags_insert(*tag_set, std::forward<First>(first), std::forward<Rest>(rest)...);
+            return *this;
+        }
+
+        /**
+        * @brief get tag names, sorted
+        */
+        std::vector<std::string_view> tags() const
+        {
+            return detail::tags_names(*tag_set);
+        }
+
+        /**
+        * @brief register test
+        */
+        suite& add(test new_test) noexcept
+        {
+            auto& ntst = test_list.emplace_back(std::move(new_test));
+            ntst.owner(suite_name);
+            ntst.inherited = tag_set;   // inherit suite tags
+            test_index.try_emplace(ntst.name(), test_list.size() - 1);
+            return *this;
+        }
+
+        /**
+        * @brief register a test defined with DOUGH_TEST
+        */
+        void add(detail::static_test& entry)
+        {
+            auto& ntst = test_list.emplace_back(std::string(entry.test_name));
+            ntst.function = entry.function;
+            if (entry.fuzz) ntst.cases = detail::fuzz_engine(entry.fuzz);
+            ntst.tag_set = entry.interned_tags();
+            ntst.owner(suite_name);
+            ntst.inherited = tag_set;   // inherit suite tags
+            test_index.try_emplace(ntst.name(), test_list.size() - 1);
+            entry.materialized = true;
+        }
+
+        /**
+        * @brief register benchmark
+        */
+        suite& add(bench new_bench) noexcept
+        {
+            auto& nbch = bench_list.emplace_back(std::move(new_bench));
+            nbch.owner(suite_name);
+            nbch.inherited = tag_set;   // inherit suite tags
+            return *this;
+        }
+
+        /**
+        * @brief set name
+        */
+        suite& name(std::string new_name) noexcept
+        {
+            suite_name = std::move(new_name);
+            return *this;
+        }
+
+        /**
+        * @brief get name
+        */
+        const std::string& name() const noexcept
+        {
+            return suite_name;
+        }
+
+        /**
+        * @brief get list of tests
+        */
+        const detail::block_list<test>& tests() const noexcept
+        {
+            return test_list;
+        }
+
+        /**
+        * @brief find test by name in constant time, nullptr if there is none
+        */
+        const test* find(std::string_view name) const
+        {
+            auto it = test_index.find(name);
+            return it == test_index.end() ? nullptr : &test_list[it->second];
+        }
+
+        /**
+        * @brief get list of benchmarks
+        */
+        const detail::block_list<bench>& benches() const noexcept
+        {
+            return bench_list;
+        }
+
+        /**
+        * @brief run all tests in a suite
+        */
+        stats run()
+        {
+            auto& rep = detail::console();
+            rep.on_suite_start(suite_name);
+            stats st;
+            detail::suite_session session(suite_name, once, test_list.size());
+            for (auto& test : test_list)
+            {
+                st.add(test.name(), run_test(test, rep, session));
+            }
+            st.fixture_teardown = session.finish();
+            rep.on_suite_end(suite_name, st);
+            return st;
+        }
+
+        /**
+        * @brief run specific test by name
+        */
+        void run(std::string_view name)
+        {
+            auto it = test_index.find(name);
+            if (it == test_index.end()) return;
+
+            detail::suite_session session(suite_name, once, 1);
+            run_test(test_list[it->second], detail::console(), session);
+        }
+
+        /**
+        * @brief run test with tag filtering. test runs if at leas one of required tags is present. test is excluded by the same logic
+        */
+        stats run(
+            const include_tags& inc_tags,
+            const exclude_tags& exc_tags = {})
+        {
+            auto& rep = detail::console();
+            stats st;
+            rep.on_suite_start(suite_name);
+            detail::tag_filter filter(inc_tags, exc_tags);
+            if (filter.excluded(*tag_set))
+            {
+                rep.on_suite_end(suite_name, st);
+                return st;
+            }
+            auto selected = select(filter);
+            detail::suite_session session(suite_name, once, selected.size());
+            for (auto* test : selected)
+            {
+                st.add(test->name(), run_test(*test, rep, session));
+            }
+            st.fixture_teardown = session.finish();
+            rep.on_suite_end(suite_name, st);
+            return st;
+        }
+
+    private:
+        /**
+        * @brief run a single test and report it.
+        * in parallel runs this is called from worker threads, one test of the suite at a time unless it is parallel()
+        */
+        detail::outcome run_test(test& tst, reporter& rep, detail::suite_session& session, const detail::run_context& ctx = {})
+        {
+            detail::failure fail;
+            rep.on_test_start(suite_name, tst.name());
+            auto result = run_test(tst, fail, session, &rep, ctx);
+            rep.on_test_end(test_result(suite_name, tst.name(), result, fail));
+            return result;
+        }
+
+        /**
+        * @brief run a single test between setup and teardown, timing each part. 
+        * the suite is set up through session first if this is its first test. 
+        * only failed cases of a parameterized test are reported, to rep if given. 
+        * a failure is kept in fail
+        */
+        detail::outcome run_test(test& tst, detail::failure& fail, detail::suite_session& session, reporter* rep = nullptr, const detail::run_context& ctx = {})
+        {
+            detail::outcome result;
+            result.fixture_setup = session.enter(fail);
+            if (!fail.error.empty())
+            {
+                session.leave();
+                return result;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (setup_function) setup_function();
+            result.setup = detail::since(start);
+
+            tst.run(result, fail, rep, ctx);
+
+            start = std::chrono::steady_clock::now();
+            if (teardown_function) teardown_function();
+            result.teardown = detail::since(start);
+
+            session.leave();
+            return result;
+        }
+
+        /**
+        * @brief whether parallel runs must keep the tests of the suite on one worker
+        */
+        bool serial() const noexcept
+        {
+            return !parallel_tests && (setup_function || teardown_function);
+        }
+
+        /**
+        * @brief get tests passing the tag filter, in registration order
+        */
+        std::vector<test*> select(const detail::tag_filter& filter)
+        {
+            // suite tags are checked once, the caller already skipped excluded suites
+            bool suite_included = filter.included(*tag_set);
+
+            std::vector<test*> selected;
+            for (auto& test : test_list)
+            {
+                // skip test with excluded tag
+                if (filter.excluded(test.tag_set)) continue;
+
+                // run if has at least one required tag or if no include tags are specified
+                if (!suite_included && !filter.included(test.tag_set)) continue;
+
+                if (filter.matches(*tag_set, test.tag_set)) selected.push_back(&test);
+            }
+            return selected;
+        }
+
+        /**
+        * @brief run a single benchmark between setup and teardown, after setup_once through session. 
+        * does not report, a failure is kept in fail
+        */
+        detail::outcome run_bench(bench& bch, bench_result& result, detail::failure& fail, detail::suite_session& session, bool perf = false)
+        {
+            detail::outcome outcome;
+            outcome.fixture_setup = session.enter(fail);
+            if (!fail.error.empty())
+            {
+                session.leave();
+                return outcome;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (setup_function) setup_function();
+            outcome.setup = detail::since(start);
+
+            bch.run(result, outcome, fail, perf);
+
+            start = std::chrono::steady_clock::now();
+            if (teardown_function) teardown_function();
+            outcome.teardown = detail::since(start);
+
+            session.leave();
+            return outcome;
+        }
+
+        /**
+        * @brief get benchmarks passing the tag filter, in registration order
+        */
+        std::vector<bench*> select_benches(const detail::tag_filter& filter)
+        {
+            bool suite_included = filter.included(*tag_set);
+
+            std::vector<bench*> selected;
+            for (auto& bch : bench_list)
+            {
+                if (filter.excluded(bch.tag_set)) continue;
+
+                if (!suite_included && !filter.included(bch.tag_set)) continue;
+
+                if (filter.matches(*tag_set, bch.tag_set)) selected.push_back(&bch);
+            }
+            return selected;
+        }
+
+    private:
+        std::shared_ptr<detail::tag_set> tag_set = std::make_shared<detail::tag_set>();
+        detail::small_function<void()> setup_function;
+        detail::small_function<void()> teardown_function;
+        detail::suite_fixture once;                 // see setup_once(), teardown_once() and fixture()
+        bool parallel_tests = false;                // see parallel()
+        std::string suite_name;
+        detail::block_list<test> test_list;         // tests never move, so selections can point at them
+        detail::block_list<bench> bench_list;
+        std::unordered_map<std::string_view, size_t> test_index;   // first test of each name, views the stable names
+    };
+
+    namespace detail
+    {
+        /**
+        * @brief escape string for xml text and attribute values
+        */
+        inline std::string xml_escape(std::string_view str)
+        {
+            std::string result;
+            result.reserve(str.size());
+            for (char c : str)
+            {
+                switch (c)
+                {
+                case '&': result += "&amp;"; break;
+                case '<': result += "&lt;"; break;
+                case '>': result += "&gt;"; break;
+                case '"': result += "&quot;"; break;
+                case '\'': result += "&apos;"; break;
+                case '\n': result += "&#10;"; break;
+                case '\r': result += "&#13;"; break;
+                case '\t': result += "&#9;"; break;
+                default:
+                    // other control characters are not allowed in xml 1.0 at all
+                    if (static_cast<unsigned char>(c) < 0x20) result += '?';
+                    else result += c;
+                }
+            }
+            return result;
+        }
+
+    }
+
+    /**
+    * @class console_reporter
+    * @brief human readable output, the default. writes through the output pipeline, or to the given stream.
+    * in quiet mode only progress in 10% steps and a short summary are printed, so the output 
+    * does not grow with the number of tests
+    */
+    class console_reporter : public reporter
+    {
+    public:
+        explicit console_reporter(unsigned slowest = 0, bool quiet = false, std::ostream* out = nullptr) noexcept
+            : slowest_count(slowest), quiet_mode(quiet), stream(out)
+        {
+        }
+
+        bool concurrent() const noexcept override
+        {
+            return stream == nullptr;
+        }
+
+        void on_run_start(size_t count) override
+        {
+            total = count;
+            done = 0;
+            failed = 0;
+        }
+
+        void on_suite_start(const std::string& suite_name) override
+        {
+            if (quiet_mode) return;
+            write(std::format("[SUITE] {} started\n", suite_name));
+        }
+
+        void on_test_start(const std::string& suite_name, const std::string& test_name) override
+        {
+            if (quiet_mode) return;
+            write(std::format("[RUN  ] {} :: {}\n", suite_name, test_name));
+        }
+
+        void on_test_end(const test_result& result) override
+        {
+            if (quiet_mode)
+            {
+                progress(result.outcome.passed);
+                return;
+            }
+
+            const auto& outcome = result.outcome;
+            bool tracked = detail::alloc_tracking.load(std::memory_order_relaxed);
+            std::string cases = outcome.cases > 0 ? std::format(", {} cases", outcome.cases) : "";
+            if (tracked) cases += ", " + detail::alloc_format(outcome.memory);
+            if (outcome.passed)
+                write(std::format("[PASS ] {} :: {} ({}{})\n", result.suite, result.name, detail::duration_format(outcome.wall), cases));
+            else if (outcome.failed_cases > 0)
+                write((result.failure ? result.failure->msg() : std::format("[ERROR] Test '{}' {}\n", result.name, result.error)) +
+                    std::format("[FAIL ] {} :: {} failed {} of {} cases\n", result.suite, result.name, outcome.failed_cases, outcome.cases));
+            else if (result.failure)
+                write(result.failure->msg());
+            else if (outcome.timed_out)
+                write_error(std::format("[TIME ] {} :: {} {}\n", result.suite, result.name, result.error));
+            else if (result.crashed)
+                write_error(std::format("[CRASH] {} :: {} took down its worker: {}\n", result.suite, result.name, result.error));
+            else if (!result.error.empty())
+                write_error(std::format("[ERROR] Test '{}' threw an exception: {}\n", result.name, result.error));
+
+            if (!outcome.passed && tracked)
+                write(std::format("[ALLOC] {} :: {} {}\n", result.suite, result.name, detail::alloc_format(outcome.memory)));
+        }
+
+        void on_case_end(const case_result& result) override
+        {
+            if (quiet_mode) return;
+
+            if (result.failure)
+            {
+                write(std::format("[CASE ] {} :: {} case #{} ({}) failed {}: expected {}, actual {}\n", result.suite, result.name,
+                    result.index, result.value, result.failure->check, result.failure->expected(), result.failure->actual()));
+            }
+            else
+            {
+                write_error(std::format("[CASE ] {} :: {} case #{} ({}) threw an exception: {}\n", result.suite, result.name,
+                    result.index, result.value, result.error));
+            }
+        }
+
+        void on_bench_start(const std::string& suite_name, const std::string& bench_name) override
+        {
+            write(std::format("[BENCH] {} :: {}\n", suite_name, bench_name));
+        }
+
+        void on_bench_end(const bench_report& report) override
+        {
+            if (report.result) write(measurements(report));
+            else if (report.failure) write(report.failure->msg());
+            else if (!report.error.empty())
+                write_error(std::format("[ERROR] Benchmark '{}' threw an exception: {}\n", report.name, report.error));
+
+            if (!report.result || !report.compared) return;
+            if (!report.baseline)
+            {
+                write(std::format("[BASE ] {} :: {} has no baseline\n", report.suite, report.name));
+                return;
+            }
+
+            std::stringstream sstr;
+            if (report.regressed)
+            {
+                sstr << "[FAIL ] Benchmark regression : " << report.suite << " :: " << report.name << '\n' <<
+                    "        Baseline     : " << detail::nanoseconds_format(report.baseline->median) << " (median)\n" <<
+                    "        Actual       : " << detail::nanoseconds_format(report.result->median) << " (median)\n" <<
+                    "        Change       : " << std::format("{:+.2f}% (threshold {:.2f}%)", report.change * 100, report.threshold * 100) << '\n' <<
+                    "        p-value      : " << std::format("{:.4f}", report.p_value) << "\n\n";
+            }
+            else
+            {
+                sstr << "[BASE ] " << report.suite << " :: " << report.name <<
+                    std::format(" {:+.2f}% vs baseline (p = {:.4f})\n", report.change * 100, report.p_value);
+            }
+            write(sstr.str());
+        }
+
+        void on_suite_end(const std::string& suite_name, const suite_stats& st) override
+        {
+            if (quiet_mode || st.run == 0) return;
+
+            std::stringstream sstr;
+            sstr << "\n[=== SUITE: " << suite_name << " ===]\n" <<
+                "    Run      : " << st.run << '\n' <<
+                "    Pass     : " << st.pass << '\n' <<
+                "    Fail     : " << st.fail << '\n';
+            if (!st.cancelled.empty())
+            {
+                sstr << "    Cancelled: " << st.cancelled.size() << '\n';
+            }
+            sstr << "    Time     : " << detail::duration_format(st.wall) <<
+                " (cpu " << detail::duration_format(st.cpu) <<
+                ", setup " << detail::duration_format(st.setup) <<
+                ", teardown " << detail::duration_format(st.teardown) << ")\n";
+            if (st.fixture_setup.count() > 0 || st.fixture_teardown.count() > 0)
+            {
+                sstr << "    Fixture  : setup " << detail::duration_format(st.fixture_setup) <<
+                    ", teardown " << detail::duration_format(st.fixture_teardown) << '\n';
+            }
+            if (detail::alloc_tracking.load(std::memory_order_relaxed))
+            {
+                sstr << "    Memory   : " << detail::alloc_format(st.memory) << '\n';
+            }
+            if (auto counters = detail::counters_format(st.perf); !counters.empty())
+            {
+                sstr << "    Counters : " << counters << '\n';
+            }
+            if (auto resources = detail::resources_format(st.perf); !resources.empty())
+            {
+                sstr << "    Resources: " << resources << '\n';
+            }
+            if (const auto* slow = st.slowest())
+            {
+                sstr << "    Slowest  : " << slow->name << " (" << detail::duration_format(slow->result.wall) << ")\n";
+            }
+            if (st.fail > 0)
+            {
+                sstr << "    Failures : \n";
+                for (int i = 0; i < st.failed.size(); ++i)
+                    sstr << "     - " << st.failed[i] << (i == st.failed.size() - 1 ? "" : "\n");
+            }
+            sstr << "\n\n";
+            write(sstr.str());
+        }
+
+        void on_summary(const run_summary& sum) override
+        {
+            if (sum.stats.size() == 0) return;
+
+            int run = 0,
+                pass = 0,
+                fail = 0;
+            size_t cancelled = 0;
+            std::chrono::nanoseconds wall{},
+                cpu{};
+            std::stringstream failures;
+            size_t listed = 0;
+            std::vector<std::pair<const std::string*, const suite_stats::timing*>> times;
+
+            for (const auto& [name, stat] : sum.stats)
+            {
+                cancelled += stat.cancelled.size();
+                if (stat.run == 0) continue;
+
+                run += stat.run;
+                pass += stat.pass;
+                fail += stat.fail;
+                wall += stat.wall;
+                cpu += stat.cpu;
+
+                for (int i = 0; i < stat.failed.size(); ++i)
+                {
+                    // quiet output stays short, however many tests failed
+                    if (quiet_mode && listed == max_quiet_failures) break;
+                    failures << "     - " << name << " :: " << stat.failed[i] << '\n';
+                    listed++;
+                }
+                if (slowest_count > 0)
+                {
+                    for (const auto& time : stat.times) times.emplace_back(&name, &time);
+                }
+            }
+            if (listed < static_cast<size_t>(fail))
+            {
+                failures << "     - ... and " << static_cast<size_t>(fail) - listed << " more\n";
+            }
+
+            std::stringstream sstr;
+            sstr << "\n ---------------------------";
+            sstr << "\n[===== OVERALL SUMMARY =====]\n" <<
+                " ---------------------------\n" <<
+                "    Total    : " << run << '\n' <<
+                "    Passed   : " << pass << '\n' <<
+                "    Failed   : " << fail << '\n' <<
+                (cancelled > 0 ? std::format("    Cancelled: {}\n", cancelled) : "") <<
+                "    Time     : " << detail::duration_format(sum.wall) <<
+                " (tests " << detail::duration_format(wall) <<
+                ", cpu " << detail::duration_format(cpu) << ")\n";
+
+            if (fail > 0)
+            {
+                sstr << "    Failures :\n" << failures.str();
+            }
+            else
+            {
+                if (run > 0) sstr << "[DOUGH] All tests passed";
+            }
+
+            if (slowest_count > 0 && !times.empty())
+            {
+                // stable, so ties keep the summary order
+                size_t count = std::min<size_t>(slowest_count, times.size());
+                std::stable_sort(times.begin(), times.end(), [](const auto& a, const auto& b)
+                    {
+                        return a.second->result.wall > b.second->result.wall;
+                    });
+
+                sstr << (fail > 0 ? "" : "\n") << "    Slowest  :\n";
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const auto& result = times[i].second->result;
+                    sstr << std::format("     - {:>10} (cpu {:>10}, setup {:>10}, teardown {:>10})  {} :: {}\n",
+                        detail::duration_format(result.wall), detail::duration_format(result.cpu),
+                        detail::duration_format(result.setup), detail::duration_format(result.teardown),
+                        *times[i].first, times[i].second->name);
+                }
+            }
+
+            sstr << '\n';
+            write(sstr.str());
+        }
+
+        void on_list(const std::vector<suite>& suites) override
+        {
+            auto tags_print = [](std::stringstream& sstr, const std::vector<std::string_view>& sorted)
+                {
+                    if (sorted.empty()) return;
+
+                    // - name [ tag1, tag2 ]
+                    sstr << " [ ";
+                    for (size_t i = 0; i < sorted.size(); ++i)
+                    {
+                        sstr << sorted[i] << (i + 1 < sorted.size() ? ", " : "");
+                    }
+                    sstr << " ]";
+                };
+
+            std::stringstream sstr;
+            for (const auto& st : suites)
+            {
+                sstr << "\n- " << st.name();
+                tags_print(sstr, st.tags());
+                sstr << '\n';
+
+                const auto tab = "    ";
+                if (st.tests().empty() && st.benches().empty())
+                {
+                    sstr << tab << "*no registered tests*";
+                }
+                for (const auto& tst : st.tests())
+                {
+                    sstr << tab << "- " << tst.name();
+                    tags_print(sstr, tst.tags());
+                    sstr << '\n';
+                }
+                for (const auto& bch : st.benches())
+                {
+                    sstr << tab << "- [bench] " << bch.name();
+                    tags_print(sstr, bch.tags());
+                    sstr << '\n';
+                }
+            }
+            sstr << '\n';
+            write(sstr.str());
+        }
+
+    private:
+        /**
+        * @brief quiet mode: count a finished test, print each 10% step once
+        */
+        void progress(bool passed)
+        {
+            size_t count = ++done;
+            size_t failures = passed ? failed.load() : ++failed;
+            if (total == 0) return;
+
+            size_t step = count * 10 / total;
+            if (step != (count - 1) * 10 / total)
+            {
+                write(std::format("[DOUGH] {:>3}% ({}/{}), {} failed\n", step * 10, count, total, failures));
+            }
+        }
+
+        /**
+        * @brief format benchmark measurements
+        */
+        static std::string measurements(const bench_report& report)
+        {
+            const auto& result = *report.result;
+            std::stringstream sstr;
+            sstr << "[PASS ] " << report.suite << " :: " << report.name << '\n' <<
+                "        Iterations   : " << result.iterations << " x " << result.samples.size() << " samples\n" <<
+                "        Mean         : " << detail::nanoseconds_format(result.mean) << '\n' <<
+                "        Median       : " << detail::nanoseconds_format(result.median) << '\n' <<
+                "        Stddev       : " << detail::nanoseconds_format(result.stddev) << '\n' <<
+                "        Min          : " << detail::nanoseconds_format(result.min) << '\n';
+            if (result.bytes > 0 && result.median > 0)
+            {
+                sstr << "        Bytes        : " << std::format("{:.3f} GB/s", result.bytes / result.median) << '\n';
+            }
+            if (result.items > 0 && result.median > 0)
+            {
+                sstr << "        Items        : " << std::format("{:.3f} M/s", result.items / result.median * 1e3) << '\n';
+            }
+            for (const auto& [counter, value] : result.counters)
+            {
+                sstr << "        " << std::format("{:<13}", counter) << ": " << value << '\n';
+            }
+            return sstr.str();
+        }
+
+        void write(std::string text)
+        {
+            if (stream) *stream << text;
+            else detail::print(std::move(text));
+        }
+
+        void write_error(std::string text)
+        {
+            if (stream) *stream << text;
+            else detail::print_error(std::move(text));
+        }
+
+    private:
+        static constexpr size_t max_quiet_failures = 10;
+
+        unsigned slowest_count = 0;
+        bool quiet_mode = false;
+        std::ostream* stream = nullptr;
+        size_t total = 0;
+        std::atomic<size_t> done{ 0 },
+            failed{ 0 };
+    };
+
+    /**
+    * @class junit_reporter
+    * @brief junit xml, one testcase element per test (classname is the suite) written as it finishes.
+    * all testcases go into one testsuite element, suites of a parallel run are interleaved.
+    * the counts are not known when the element is opened, junit consumers count the testcases themselves
+    */
+    class junit_reporter : public reporter
+    {
+    public:
+        explicit junit_reporter(std::ostream& out) noexcept : stream(out) {}
+
+        void on_run_start(size_t) override
+        {
+            char timestamp[32] = {};
+            std::time_t now = std::time(nullptr);
+            if (const std::tm* local = std::localtime(&now))
+            {
+                std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", local);
+            }
+
+            stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" <<
+                "<testsuites name=\"dough\">\n" <<
+                "  <testsuite name=\"dough\" timestamp=\"" << timestamp << "\">\n";
+            open = true;
+        }
+
+        void on_test_end(const test_result& result) override
+        {
+            testcase(result.suite, result.name, result.outcome, result.failure, result.error, result.crashed);
+        }
+
+        void on_bench_end(const bench_report& report) override
+        {
+            if (!report.regressed)
+            {
+                testcase(report.suite, report.name, report.outcome, report.failure, report.error, false);
+                return;
+            }
+
+            stream << std::format("    <testcase classname=\"{}\" name=\"{}\" time=\"{:.6f}\">\n",
+                detail::xml_escape(report.suite), detail::xml_escape(report.name), seconds(report.outcome.elapsed())) <<
+                std::format("      <failure message=\"median {:+.2f}% vs baseline (p = {:.4f})\" type=\"regression\"/>\n",
+                    report.change * 100, report.p_value) <<
+                "    </testcase>\n";
+        }
+
+        void on_suite_end(const std::string&, const suite_stats&) override
+        {
+            stream.flush();
+        }
+
+        void on_summary(const run_summary& sum) override
+        {
+            if (!open) return;
+
+            // tests cancelled by --fail-fast never ran, they are listed as skipped
+            for (const auto& [name, st] : sum.stats)
+            {
+                for (const auto& cancelled : st.cancelled)
+                {
+                    stream << std::format("    <testcase classname=\"{}\" name=\"{}\" time=\"0\">\n",
+                        detail::xml_escape(name), detail::xml_escape(cancelled)) <<
+                        "      <skipped message=\"cancelled\"/>\n" <<
+                        "    </testcase>\n";
+                }
+            }
+            stream << "  </testsuite>\n</testsuites>\n";
+            stream.flush();
+            open = false;
+        }
+
+    private:
+        static double seconds(std::chrono::nanoseconds time) noexcept
+        {
+            return std::chrono::duration<double>(time).count();
+        }
+
+        void testcase(
+            const std::string& suite_name,
+            const std::string& name,
+            const detail::outcome& outcome,
+            const detail::test_fail* failure,
+            std::string_view error,
+            bool crashed)
+        {
+            stream << std::format("    <testcase classname=\"{}\" name=\"{}\" time=\"{:.6f}\"",
+                detail::xml_escape(suite_name), detail::xml_escape(name), seconds(outcome.elapsed()));
+
+            if (outcome.passed)
+            {
+                stream << "/>\n";
+                return;
+            }
+
+            stream << ">\n";
+            if (failure)
+            {
+                stream << std::format("      <failure message=\"{}\" type=\"{}\">", detail::xml_escape(failure->text), failure->check) <<
+                    detail::xml_escape(std::format("{}:{}\nExpected: {}\nActual: {}",
+                        failure->where.file_name(), failure->where.line(), failure->expected(), failure->actual())) <<
+                    "</failure>\n";
+            }
+            else if (!error.empty())
+            {
+                stream << std::format("      <error message=\"{}\" type=\"{}\"/>\n",
+                    detail::xml_escape(error), outcome.timed_out ? "timeout" : crashed ? "crash" : "exception");
+            }
+            else
+            {
+                stream << "      <failure message=\"test did not pass\"/>\n";
+            }
+            stream << "    </testcase>\n";
+        }
+
+    private:
+        std::ostream& stream;
+        bool open = false;
+    };
+
+    /**
+    * @class jsonl_reporter
+    * @brief json lines, one object per event with an "event" member, written as it happens.
+    * times are in nanoseconds
+    */
+    class jsonl_reporter : public reporter
+    {
+    public:
+        explicit jsonl_reporter(std::ostream& out) noexcept : stream(out) {}
+
+        void on_run_start(size_t count) override
+        {
+            stream << std::format("{{\"event\":\"run_start\",\"count\":{}}}\n", count);
+        }
+
+        void on_suite_start(const std::string& suite_name) override
+        {
+            stream << std::format("{{\"event\":\"suite_start\",\"suite\":\"{}\"}}\n", detail::json_escape(suite_name));
+        }
+
+        void on_test_start(const std::string& suite_name, const std::string& test_name) override
+        {
+            stream << std::format("{{\"event\":\"test_start\",\"suite\":\"{}\",\"test\":\"{}\"}}\n",
+                detail::json_escape(suite_name), detail::json_escape(test_name));
+        }
+
+        void on_test_end(const test_result& result) override
+        {
+            const auto& outcome = result.outcome;
+            stream << std::format("{{\"event\":\"test_end\",\"suite\":\"{}\",\"test\":\"{}\",\"id\":\"{}\",\"status\":\"{}\","
+                "\"wall_ns\":{},\"cpu_ns\":{},\"setup_ns\":{},\"teardown_ns\":{}",
+                detail::json_escape(result.suite), detail::json_escape(result.name), detail::id_format(result.id),
+                outcome.timed_out ? "timeout" : status(outcome.passed, result.failure, result.error, result.crashed),
+                outcome.wall.count(), outcome.cpu.count(), outcome.setup.count(), outcome.teardown.count());
+            if (outcome.cases > 0) stream << std::format(",\"cases\":{},\"failed_cases\":{}", outcome.cases, outcome.failed_cases);
+            if (detail::alloc_tracking.load(std::memory_order_relaxed))
+            {
+                stream << std::format(",\"allocations\":{},\"allocated_bytes\":{},\"peak_bytes\":{},\"leaked_blocks\":{}",
+                    outcome.memory.allocations, outcome.memory.bytes, outcome.memory.peak, outcome.memory.leaked);
+            }
+            perf(outcome.perf);
+            failure(result.failure, result.error);
+            stream << "}\n";
+        }
+
+        void on_case_end(const case_result& result) override
+        {
+            stream << std::format("{{\"event\":\"case_end\",\"suite\":\"{}\",\"test\":\"{}\",\"index\":{},\"value\":\"{}\",\"status\":\"{}\"",
+                detail::json_escape(result.suite), detail::json_escape(result.name), result.index, detail::json_escape(result.value),
+                status(false, result.failure, result.error, false));
+            failure(result.failure, result.error);
+            stream << "}\n";
+        }
+
+        void on_bench_start(const std::string& suite_name, const std::string& bench_name) override
+        {
+            stream << std::format("{{\"event\":\"bench_start\",\"suite\":\"{}\",\"bench\":\"{}\"}}\n",
+                detail::json_escape(suite_name), detail::json_escape(bench_name));
+        }
+
+        void on_bench_end(const bench_report& report) override
+        {
+            stream << std::format("{{\"event\":\"bench_end\",\"suite\":\"{}\",\"bench\":\"{}\",\"status\":\"{}\"",
+                detail::json_escape(report.suite), detail::json_escape(report.name),
+                report.regressed ? "regressed" : status(report.result != nullptr, report.failure, report.error, false));
+            if (const auto* result = report.result)
+            {
+                stream << std::format(",\"iterations\":{},\"samples\":{},\"mean_ns\":{},\"median_ns\":{},\"stddev_ns\":{},\"min_ns\":{}",
+                    result->iterations, result->samples.size(), result->mean, result->median, result->stddev, result->min);
+            }
+            if (report.baseline)
+            {
+                stream << std::format(",\"baseline_median_ns\":{},\"change\":{},\"p_value\":{}",
+                    report.baseline->median, report.change, report.p_value);
+            }
+            perf(report.outcome.perf);
+            failure(report.failure, report.error);
+            stream << "}\n";
+        }
+
+        void on_suite_end(const std::string& suite_name, const suite_stats& st) override
+        {
+            stream << std::format("{{\"event\":\"suite_end\",\"suite\":\"{}\",\"run\":{},\"pass\":{},\"fail\":{},\"cancelled\":{},\"wall_ns\":{},\"cpu_ns\":{},"
+                "\"fixture_setup_ns\":{},\"fixture_teardown_ns\":{}}}\n",
+                detail::json_escape(suite_name), st.run, st.pass, st.fail, st.cancelled.size(), st.wall.count(), st.cpu.count(),
+                st.fixture_setup.count(), st.fixture_teardown.count());
+            stream.flush();
+        }
+
+        void on_summary(const run_summary& sum) override
+        {
+            int run = 0,
+                pass = 0,
+                fail = 0;
+            size_t cancelled = 0;
+            for (const auto& [name, st] : sum.stats)
+            {
+                run += st.run;
+                pass += st.pass;
+                fail += st.fail;
+                cancelled += st.cancelled.size();
+            }
+            stream << std::format("{{\"event\":\"summary\",\"run\":{},\"pass\":{},\"fail\":{},\"cancelled\":{},\"wall_ns\":{}}}\n",
+                run, pass, fail, cancelled, sum.wall.count());
+            stream.flush();
+        }
+
+        void on_list(const std::vector<suite>& suites) override
+        {
+            auto tags = [](const std::vector<std::string_view>& sorted)
+                {
+                    std::string result = "[";
+                    for (const auto& tag : sorted)
+                    {
+                        result += std::format("{}\"{}\"", result.size() > 1 ? "," : "", detail::json_escape(tag));
+                    }
+                    return result + "]";
+                };
+
+            for (const auto& st : suites)
+            {
+                stream << std::format("{{\"event\":\"list\",\"suite\":\"{}\",\"tags\":{}}}\n", detail::json_escape(st.name()), tags(st.tags()));
+                for (const auto& tst : st.tests())
+                {
+                    stream << std::format("{{\"event\":\"list\",\"suite\":\"{}\",\"test\":\"{}\",\"id\":\"{}\",\"tags\":{}}}\n",
+                        detail::json_escape(st.name()), detail::json_escape(tst.name()), detail::id_format(tst.id()), tags(tst.tags()));
+                }
+                for (const auto& bch : st.benches())
+                {
+                    stream << std::format("{{\"event\":\"list\",\"suite\":\"{}\",\"bench\":\"{}\",\"tags\":{}}}\n",
+                        detail::json_escape(st.name()), detail::json_escape(bch.name()), tags(bch.tags()));
+                }
+            }
+            stream.flush();
+        }
+
+    private:
+        static const char* status(bool passed, const detail::test_fail* failure, std::string_view error, bool crashed) noexcept
+        {
+            if (passed) return "pass";
+            if (crashed) return "crash";
+            if (!failure && !error.empty()) return "error";
+            return "fail";
+        }
+
+        /**
+        * @brief counters and rusage fields, only those that were measured
+        */
+        void perf(const detail::perf_usage& usage)
+        {
+            constexpr std::array<const char*, detail::perf_usage::event_count> names{ "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses" };
+            for (unsigned e = 0; e < names.size(); ++e)
+            {
+                if (usage.counted(static_cast<detail::perf_usage::event>(e))) stream << std::format(",\"{}\":{}", names[e], usage.counts[e]);
+            }
+            if (!usage.resources) return;
+            stream << std::format(",\"user_ns\":{},\"system_ns\":{},\"voluntary_switches\":{},\"involuntary_switches\":{},\"minor_faults\":{},\"major_faults\":{}",
+                usage.user.count(), usage.system.count(), usage.voluntary_switches, usage.involuntary_switches, usage.minor_faults, usage.major_faults);
+        }
+
+        void failure(const detail::test_fail* fail, std::string_view error)
+        {
+            if (fail)
+            {
+                stream << std::format(",\"check\":\"{}\",\"file\":\"{}\",\"line\":{},\"expected\":\"{}\",\"actual\":\"{}\",\"message\":\"{}\"",
+                    fail->check, detail::json_escape(fail->where.file_name()), fail->where.line(),
+                    detail::json_escape(fail->expected()), detail::json_escape(fail->actual()), detail::json_escape(fail->text));
+            }
+            else if (!error.empty())
+            {
+                stream << std::format(",\"error\":\"{}\"", detail::json_escape(error));
+            }
+        }
+
+    private:
+        std::ostream& stream;
+    };
+
+    /**
+    * @class tap_reporter
+    * @brief test anything protocol, version 13. one test point per test in the order they finish,
+    * failures carry a yaml block with the details
+    */
+    class tap_reporter : public reporter
+    {
+    public:
+        explicit tap_reporter(std::ostream& out) noexcept : stream(out) {}
+
+        void on_run_start(size_t count) override
+        {
+            stream << "TAP version 13\n1.." << count << '\n';
+            number = 0;
+        }
+
+        void on_test_end(const test_result& result) override
+        {
+            point(result.outcome.passed, result.suite, result.name);
+            if (result.outcome.passed) return;
+
+            stream << "  ---\n";
+            if (result.failure) failure(*result.failure);
+            else if (!result.error.empty())
+            {
+                stream << "  " << (result.outcome.timed_out ? "timeout" : result.crashed ? "crash" : "error") << ": \"" << detail::json_escape(result.error) << "\"\n";
+            }
+            stream << "  ...\n";
+        }
+
+        void on_bench_end(const bench_report& report) override
+        {
+            bool passed = report.result && !report.regressed;
+            point(passed, report.suite, report.name);
+
+            if (report.result)
+            {
+                stream << std::format("  # median {}", detail::nanoseconds_format(report.result->median));
+                if (report.baseline) stream << std::format(", {:+.2f}% vs baseline (p = {:.4f})", report.change * 100, report.p_value);
+                stream << '\n';
+            }
+            if (passed) return;
+
+            stream << "  ---\n";
+            if (report.failure) failure(*report.failure);
+            else if (!report.error.empty()) stream << "  error: \"" << detail::json_escape(report.error) << "\"\n";
+            else if (report.regressed) stream << "  message: \"benchmark regression\"\n";
+            stream << "  ...\n";
+        }
+
+        void on_suite_end(const std::string& suite_name, const suite_stats& st) override
+        {
+            stream << "# " << suite_name << ": " << st.run << " run, " << st.pass << " passed, " << st.fail << " failed" <<
+                (st.cancelled.empty() ? "" : std::format(", {} cancelled", st.cancelled.size())) << '\n';
+            stream.flush();
+        }
+
+        void on_summary(const run_summary& sum) override
+        {
+            // tests cancelled by --fail-fast still get their points, so the plan adds up
+            for (const auto& [name, st] : sum.stats)
+            {
+                for (const auto& cancelled : st.cancelled) point(true, name, cancelled, " # SKIP cancelled");
+            }
+            stream << "# time " << detail::duration_format(sum.wall) << '\n';
+            stream.flush();
+        }
+
+    private:
+        void point(bool passed, const std::string& suite_name, const std::string& name, std::string_view directive = {})
+        {
+            // '#' starts a directive in a tap description
+            auto description = std::format("{} :: {}", suite_name, name);
+            for (size_t pos = description.find('#'); pos != description.npos; pos = description.find('#', pos + 2))
+            {
+                description.insert(pos, 1, '\\');
+            }
+            stream << (passed ? "ok " : "not ok ") << ++number << " - " << description << directive << '\n';
+        }
+
+        void failure(const detail::test_fail& fail)
+        {
+            stream << "  check: " << fail.check << '\n' <<
+                "  file: \"" << detail::json_escape(fail.where.file_name()) << "\"\n" <<
+                "  line: " << fail.where.line() << '\n' <<
+                "  expected: \"" << detail::json_escape(fail.expected()) << "\"\n" <<
+                "  actual: \"" << detail::json_escape(fail.actual()) << "\"\n" <<
+                "  message: \"" << detail::json_escape(fail.text) << "\"\n";
+        }
+
+    private:
+        std::ostream& stream;
+        size_t number = 0;
+    };
+
+    namespace detail
+    {
+        /**
+        * @brief reporter used when tests or suites are run directly instead of through a registry
+        */
+        inline reporter& console()
+        {
+            static console_reporter rep;
+            return rep;
+        }
+
+        /**
+        * @class reporter_set
+        * @brief forwards events to several reporters. the ones that are not concurrent 
+        * are called under one lock, concurrent ones go first
+        */
+        class reporter_set final : public reporter
+        {
+        public:
+            /**
+            * @brief add a reporter that is owned elsewhere
+            */
+            void add(reporter& rep)
+            {
+                auto it = rep.concurrent() ? std::find_if(list.begin(), list.end(),
+                    [](const reporter* r) { return !r->concurrent(); }) : list.end();
+                list.insert(it, &rep);
+            }
+
+            /**
+            * @brief add a reporter and keep it alive
+            */
+            void add(std::unique_ptr<reporter> rep)
+            {
+                add(*rep);
+                owned.push_back(std::move(rep));
+            }
+
+            /**
+            * @brief keep a report file open for as long as the reporters using it
+            */
+            void keep(std::unique_ptr<std::ostream> out)
+            {
+                files.push_back(std::move(out));
+            }
+
+            bool concurrent() const noexcept override { return true; }
+
+            void on_run_start(size_t count) override { each([&](reporter& rep) { rep.on_run_start(count); }); }
+            void on_suite_start(const std::string& suite_name) override { each([&](reporter& rep) { rep.on_suite_start(suite_name); }); }
+            void on_test_start(const std::string& suite_name, const std::string& test_name) override { each([&](reporter& rep) { rep.on_test_start(suite_name, test_name); }); }
+            void on_test_end(const test_result& result) override { each([&](reporter& rep) { rep.on_test_end(result); }); }
+            void on_case_end(const case_result& result) override { each([&](reporter& rep) { rep.on_case_end(result); }); }
+            void on_bench_start(const std::string& suite_name, const std::string& bench_name) override { each([&](reporter& rep) { rep.on_bench_start(suite_name, bench_name); }); }
+            void on_bench_end(const bench_report& report) override { each([&](reporter& rep) { rep.on_bench_end(report); }); }
+            void on_suite_end(const std::string& suite_name, const suite_stats& st) override { each([&](reporter& rep) { rep.on_suite_end(suite_name, st); }); }
+            void on_summary(const run_summary& sum) override { each([&](reporter& rep) { rep.on_summary(sum); }); }
+            void on_list(const std::vector<suite>& suites) override { each([&](reporter& rep) { rep.on_list(suites); }); }
+
+        private:
+            template<class F>
+            void each(F&& call)
+            {
+                std::unique_lock lock(mutex, std::defer_lock);
+                for (auto* rep : list)
+                {
+                    if (!rep->concurrent() && !lock.owns_lock()) lock.lock();
+                    call(*rep);
+                }
+            }
+
+        private:
+            std::vector<std::unique_ptr<std::ostream>> files;   // destroyed after the reporters writing to them
+            std::vector<std::unique_ptr<reporter>> owned;
+            std::vector<reporter*> list;
+            std::mutex mutex;
+        };
+    }
+
+    namespace detail
+    {
+        /**
+        * @brief number of workers to use, 0 means one per hardware thread
+        */
+        inline unsigned resolve_jobs(unsigned jobs)
+        {
+            if (jobs == 0) jobs = std::thread::hardware_concurrency();
+            return jobs == 0 ? 1 : jobs;
+        }
+
+        /**
+        * @class failure_limit
+        * @brief counts the failures of a run and stops it at the limit (options::fail_fast, 0 for none). 
+        * safe to use from worker threads
+        */
+        class failure_limit
+        {
+        public:
+            explicit failure_limit(unsigned limit) noexcept : limit(limit) {}
+
+            /**
+            * @brief count a finished test or benchmark, the one reaching the limit stops the run
+            */
+            void add(bool passed)
+            {
+                if (passed || limit == 0) return;
+                if (failures.fetch_add(1, std::memory_order_relaxed) + 1 != limit) return;
+
+                stop.store(true, std::memory_order_relaxed);
+                print_error(std::format("[DOUGH] Stopping after {} failure{} (--fail-fast), cancelling the rest\n", limit, limit == 1 ? "" : "s"));
+            }
+
+            /**
+            * @brief whether the limit was reached, nothing new should start then
+            */
+            bool stopped() const noexcept
+            {
+                return stop.load(std::memory_order_relaxed);
+            }
+
+            /**
+            * @brief the flag set at the limit, for worker pools
+            */
+            const std::atomic<bool>* flag() const noexcept
+            {
+                return &stop;
+            }
+
+        private:
+            unsigned limit;
+            std::atomic<unsigned> failures = 0;
+            std::atomic<bool> stop = false;
+        };
+
+        /**
+        * @brief calls body(task) for each task on up to jobs threads, including the calling one.
+        * tasks are started strictly in the given order: a worker that is done takes the next one 
+        * not taken yet, so the front of a priority-ordered list never waits behind its tail.
+        * an exception escaping body stops the pool and is rethrown once all workers have joined. 
+        * once cancel is set, workers finish their current task and leave the rest untaken
+        */
+        template<class F>
+        void parallel_for(const std::vector<size_t>& tasks, unsigned jobs, F&& body, const std::atomic<bool>* cancel = nullptr)
+        {
+            size_t count = std::min<size_t>(jobs, tasks.size());
+            if (count == 0) return;
+
+            // tasks are whole tests, so one shared cursor costs nothing next to them
+            std::atomic<size_t> next = 0;
+            std::atomic<bool> stop = false;
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto worker = [&]()
+                {
+                    while (!stop && !(cancel && cancel->load(std::memory_order_relaxed)))
+                    {
+                        size_t taken = next.fetch_add(1);
+                        if (taken >= tasks.size()) return;
+
+                        try
+                        {
+                            body(tasks[taken]);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard lock(error_mutex);
+                            if (!error) error = std::current_exception();
+                            stop = true;
+                        }
+                    }
+                };
+
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < count; ++i)
+            {
+                workers.emplace_back(worker);
+            }
+            worker();
+            for (auto& w : workers) w.join();
+
+            if (error) std::rethrow_exception(error);
+        }
+
+#if DOUGH_POSIX
+        /**
+        * @brief get signal name, e.g. 'SIGSEGV (Segmentation fault)'
+        */
+        inline std::string signal_name(int sig)
+        {
+            static const std::array<std::pair<int, const char*>, 10> names{ {
+                { SIGSEGV, "SIGSEGV" }, { SIGABRT, "SIGABRT" }, { SIGFPE, "SIGFPE" },
+                { SIGILL, "SIGILL" }, { SIGBUS, "SIGBUS" }, { SIGKILL, "SIGKILL" },
+                { SIGTERM, "SIGTERM" }, { SIGPIPE, "SIGPIPE" }, { SIGALRM, "SIGALRM" },
+                { SIGINT, "SIGINT" } } };
+
+            auto it = std::find_if(names.begin(), names.end(),
+                [sig](const auto& entry) { return entry.first == sig; });
+            std::string name = (it != names.end() ? it->second : std::format("signal {}", sig));
+            return std::format("{} ({})", name, strsignal(sig));
+        }
+
+        /**
+        * @brief describe how a worker process ended
+        */
+        inline std::string exit_description(int status)
+        {
+            if (WIFSIGNALED(status)) return signal_name(WTERMSIG(status));
+            if (WIFEXITED(status)) return std::format("exited with code {}", WEXITSTATUS(status));
+            return "unknown reason";
+        }
+
+        /**
+        * @brief write the whole buffer, retrying on interrupts
+        */
+        inline bool write_all(int fd, const void* data, size_t size)
+        {
+            auto* bytes = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                auto n = ::write(fd, bytes, size);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                bytes += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        /**
+        * @brief read the whole buffer, retrying on interrupts. false on eof or error
+        */
+        inline bool read_all(int fd, void* data, size_t size)
+        {
+            auto* bytes = static_cast<char*>(data);
+            while (size > 0)
+            {
+                auto n = ::read(fd, bytes, size);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                bytes += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        /**
+        * @brief serialize a test failure for the parent process. the check type and source location
+        * point into the test binary, which a forked worker shares with its parent, so they are sent as is
+        */
+        inline void failure_write(std::string& out, const failure& fail)
+        {
+            static_assert(std::is_trivially_copyable_v<std::source_location>);
+
+            auto put = [&](const void* data, size_t size) { out.append(static_cast<const char*>(data), size); };
+            auto put_string = [&](const std::string& str)
+                {
+                    size_t size = str.size();
+                    put(&size, sizeof(size));
+                    out += str;
+                };
+
+            bool check = fail.check.has_value();
+            put(&check, sizeof(check));
+            put_string(fail.error);
+            if (!check) return;
+
+            put(&fail.check->check, sizeof(fail.check->check));
+            put(&fail.check->where, sizeof(fail.check->where));
+            put_string(fail.check->text);
+            put_string(fail.check->expected());
+            put_string(fail.check->actual());
+        }
+
+        /**
+        * @brief read a failure written by failure_write in a worker. expected and actual values 
+        * arrive formatted, so they are kept as strings. false on malformed input
+        */
+        inline bool failure_read(std::string_view in, failure& fail)
+        {
+            auto get = [&](void* data, size_t size)
+                {
+                    if (in.size() < size) return false;
+                    std::memcpy(data, in.data(), size);
+                    in.remove_prefix(size);
+                    return true;
+                };
+            auto get_string = [&](std::string& str)
+                {
+                    size_t size = 0;
+                    if (!get(&size, sizeof(size)) || in.size() < size) return false;
+                    str.assign(in.substr(0, size));
+                    in.remove_prefix(size);
+                    return true;
+                };
+
+            bool check = false;
+            if (!get(&check, sizeof(check)) || !get_string(fail.error)) return false;
+            if (!check) return true;
+
+            const char* check_type = nullptr;
+            std::source_location where;
+            std::string text, expected, actual;
+            if (!get(&check_type, sizeof(check_type)) || !get(&where, sizeof(where)) ||
+                !get_string(text) || !get_string(expected) || !get_string(actual)) return false;
+
+            fail.check.emplace(text, check_type, where, expected, actual);
+            return true;
+        }
+
+        /**
+        * @brief runs tasks in a pool of forked worker processes, so a crashing task only takes down its worker.
+        * the parent hands out tasks in the given order over a pipe per worker, workers send back 
+        * body(task, payload) and the payload bytes over another pipe, the parent passes them to 
+        * on_done(task, result, payload) as they arrive. when a worker dies mid-task, 
+        * on_crash(task, reason, elapsed, timed_out) is called instead and the worker is replaced. 
+        * a worker still busy with a task past time_limit(task) (0 for none) is killed, timed_out is set then. 
+        * once cancelled() returns true no more tasks are handed out and the task pipes are closed, so 
+        * busy workers finish their task and exit. one that takes longer than stop_grace is killed, 
+        * its task dropped without a call. a worker calls on_exit() when it runs out of tasks. 
+        * the calling process must not have other threads running
+        */
+        template<class Result, class Body, class Done, class Crash, class Limit, class Cancel, class Exit>
+        void isolated_for(
+            const std::vector<size_t>& tasks,
+            unsigned jobs,
+            std::vector<Result>& results,
+            Body&& body,
+            Done&& on_done,
+            Crash&& on_crash,
+            Limit&& time_limit,
+            Cancel&& cancelled,
+            Exit&& on_exit)
+        {
+            // time a task gets past its limit to return on its own, e.g. after checking remaining_time()
+            constexpr auto kill_grace = std::chrono::milliseconds(100);
+            // time a worker of a cancelled run gets to finish its task and call on_exit()
+            constexpr auto stop_grace = std::chrono::seconds(2);
+
+            static_assert(std::is_trivially_copyable_v<Result>, "results are sent between processes as raw bytes");
+
+            struct record
+            {
+                size_t task;
+                Result result;
+                size_t payload_size;
+            };
+
+            struct worker
+            {
+                pid_t pid = -1;
+                int cmd_fd = -1;    // parent -> worker, task index
+                int res_fd = -1;    // worker -> parent, record
+                std::optional<size_t> current;
+                std::chrono::steady_clock::time_point started;
+                std::chrono::nanoseconds limit{};
+                bool timed_out = false;
+                bool killed = false;
+                bool stopped = false;   // told to exit because the run was cancelled
+                std::chrono::steady_clock::time_point stop_by;  // killed if it has not exited by then
+            };
+
+            std::vector<worker> workers(std::min<size_t>(jobs, tasks.size()));
+            size_t next = 0;
+
+            // a child forked while the writer thread holds a stream lock would deadlock, report synchronously
+            output::instance().stop();
+
+            // a write to a dead worker must not kill the parent
+            auto old_sigpipe = ::signal(SIGPIPE, SIG_IGN);
+
+            auto spawn = [&](worker& w) -> bool
+                {
+                    // flush first, otherwise buffered output is printed by both processes
+                    std::cout.flush();
+                    std::cerr.flush();
+                    std::fflush(nullptr);
+
+                    int cmd[2], res[2];
+                    if (::pipe(cmd) != 0) return false;
+                    if (::pipe(res) != 0)
+                    {
+                        ::close(cmd[0]);
+                        ::close(cmd[1]);
+                        return false;
+                    }
+
+                    pid_t pid = ::fork();
+                    if (pid == 0)
+                    {
+                        ::close(cmd[1]);
+                        ::close(res[0]);
+                        // keep output written right before a crash
+                        std::cout.setf(std::ios::unitbuf);
+                        // drop other workers' pipes, or they would never see eof
+                        for (auto& other : workers)
+                        {
+                            if (other.cmd_fd >= 0) ::close(other.cmd_fd);
+                            if (other.res_fd >= 0) ::close(other.res_fd);
+                        }
+
+                        record rec{};
+                        std::string payload;
+                        while (read_all(cmd[0], &rec.task, sizeof(rec.task)))
+                        {
+                            payload.clear();
+                            rec.result = body(rec.task, payload);
+                            rec.payload_size = payload.size();
+                            std::cout.flush();
+                            std::cerr.flush();
+                            if (!write_all(res[1], &rec, sizeof(rec))) break;
+                            if (!write_all(res[1], payload.data(), payload.size())) break;
+                        }
+                        on_exit();
+                        std::cout.flush();
+                        std::cerr.flush();
+                        ::_exit(0); // skip destructors and atexit handlers of the parent's state
+                    }
+
+                    ::close(cmd[0]);
+                    ::close(res[1]);
+                    if (pid < 0)
+                    {
+                        ::close(cmd[1]);
+                        ::close(res[0]);
+                        return false;
+                    }
+
+                    w.pid = pid;
+                    w.cmd_fd = cmd[1];
+                    w.res_fd = res[0];
+                    return true;
+                };
+
+            auto dispatch = [&](worker& w)
+                {
+                    if (next == tasks.size() || cancelled())
+                    {
+                        // nothing left, closing the pipe lets the worker exit
+                        ::close(w.cmd_fd);
+                        w.cmd_fd = -1;
+                        return;
+                    }
+
+                    size_t task = tasks[next];
+                    if (!write_all(w.cmd_fd, &task, sizeof(task)))
+                    {
+                        // worker is gone, its eof is handled in the main loop
+                        ::kill(w.pid, SIGKILL);
+                        return;
+                    }
+                    w.current = task;
+                    w.started = std::chrono::steady_clock::now();
+                    w.limit = time_limit(task);
+                    ++next;
+                };
+
+            for (auto& w : workers)
+            {
+                if (spawn(w)) dispatch(w);
+            }
+
+            std::vector<pollfd> fds;
+            std::vector<worker*> polled;
+            std::string payload;
+            while (true)
+            {
+                auto now = std::chrono::steady_clock::now();
+
+                // a cancelled run takes no more tasks. closing the pipe lets a busy worker finish 
+                // its task and exit, so suites it set up are still torn down
+                if (cancelled())
+                {
+                    for (auto& w : workers)
+                    {
+                        if (w.res_fd < 0 || w.stopped) continue;
+                        if (w.cmd_fd >= 0) ::close(w.cmd_fd);
+                        w.cmd_fd = -1;
+                        w.stopped = true;
+                        w.stop_by = now + stop_grace;
+                    }
+                }
+
+                // kill workers over time or slow to stop, their eof is handled below. otherwise wake up at the next limit
+                int wait_ms = -1;
+                for (auto& w : workers)
+                {
+                    if (w.res_fd < 0 || w.killed) continue;
+                    std::optional<std::chrono::steady_clock::time_point> kill_at;
+                    if (w.current && w.limit.count() > 0) kill_at = w.started + w.limit + kill_grace;
+                    if (w.stopped && (!kill_at || w.stop_by < *kill_at)) kill_at = w.stop_by;
+                    if (!kill_at) continue;
+
+                    auto left = std::chrono::ceil<std::chrono::milliseconds>(*kill_at - now).count();
+                    if (left > 0)
+                    {
+                        wait_ms = wait_ms < 0 ? static_cast<int>(left) : std::min(wait_ms, static_cast<int>(left));
+                        continue;
+                    }
+                    ::kill(w.pid, SIGKILL);
+                    w.killed = true;
+                    w.timed_out = !w.stopped || *kill_at != w.stop_by;
+                }
+
+                fds.clear();
+                polled.clear();
+                for (auto& w : workers)
+                {
+                    if (w.res_fd < 0) continue;
+                    fds.push_back({ w.res_fd, POLLIN, 0 });
+                    polled.push_back(&w);
+                }
+
+                if (fds.empty())
+                {
+                    // no worker could be started, finish in-process
+                    for (; next < tasks.size() && !cancelled(); ++next)
+                    {
+                        payload.clear();
+                        results[tasks[next]] = body(tasks[next], payload);
+                        on_done(tasks[next], results[tasks[next]], std::string_view(payload));
+                    }
+                    break;
+                }
+
+                if (::poll(fds.data(), fds.size(), wait_ms) < 0)
+                {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+
+                for (size_t i = 0; i < fds.size(); ++i)
+                {
+                    if (fds[i].revents == 0) continue;
+                    auto& w = *polled[i];
+
+                    // a worker that dies while sending its result counts as crashed
+                    record rec{};
+                    if (read_all(w.res_fd, &rec, sizeof(rec)) &&
+                        (payload.resize(rec.payload_size), read_all(w.res_fd, payload.data(), payload.size())))
+                    {
+                        results[rec.task] = rec.result;
+                        w.current.reset();
+                        on_done(rec.task, rec.result, std::string_view(payload));
+                        // a worker killed right as it finished gets its next task once replaced
+                        if (!w.killed && !w.stopped) dispatch(w);
+                        continue;
+                    }
+
+                    // eof: the worker exited, either on request or because it crashed
+                    if (w.cmd_fd >= 0) ::close(w.cmd_fd);
+                    ::close(w.res_fd);
+                    w.cmd_fd = w.res_fd = -1;
+
+                    int status = 0;
+                    while (::waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+                    w.pid = -1;
+                    bool timed_out = std::exchange(w.timed_out, false);
+                    bool stopped = std::exchange(w.stopped, false);
+                    w.killed = false;
+
+                    // a task cut short by the stop of a cancelled run is dropped, one over its limit still times out
+                    if (w.current && (!stopped || timed_out))
+                    {
+                        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - w.started);
+                        auto reason = timed_out ?
+                            std::format("timed out after {} (limit {}), worker killed", duration_format(elapsed), duration_format(w.limit)) :
+                            exit_description(status);
+                        results[*w.current] = on_crash(*w.current, reason, elapsed, timed_out);
+                    }
+
+                    w.current.reset();
+                    if (next < tasks.size() && !cancelled() && spawn(w)) dispatch(w);
+                }
+            }
+
+            ::signal(SIGPIPE, old_sigpipe);
+        }
+#endif
+
+        /**
+        * @struct history
+        * @brief test durations and results from previous runs, keyed by suite and test name. 
+        * a test keeps its entry until it runs again
+        */
+        struct history
+        {
+            /**
+            * @struct entry
+            * @brief last result of a test
+            */
+            struct entry
+            {
+                std::chrono::nanoseconds duration{};
+                bool failed = false;
+            };
+
+            std::unordered_map<std::string, entry> entries;
+
+            /**
+            * @brief make lookup key
+            */
+            static std::string key(std::string_view suite_name, std::string_view test_name)
+            {
+                return std::format("{}\t{}", suite_name, test_name);
+            }
+
+            /**
+            * @brief get recorded duration, if any
+            */
+            std::optional<std::chrono::nanoseconds> find(std::string_view suite_name, std::string_view test_name) const
+            {
+                auto it = entries.find(key(suite_name, test_name));
+                if (it == entries.end()) return std::nullopt;
+                return it->second.duration;
+            }
+
+            /**
+            * @brief whether the test failed the last time it ran
+            */
+            bool failed(std::string_view suite_name, std::string_view test_name) const
+            {
+                auto it = entries.find(key(suite_name, test_name));
+                return it != entries.end() && it->second.failed;
+            }
+
+            /**
+            * @brief store the result of a test that ran
+            */
+            void record(std::string_view suite_name, std::string_view test_name, std::chrono::nanoseconds duration, bool failed)
+            {
+                entries[key(suite_name, test_name)] = { duration, failed };
+            }
+
+            /**
+            * @brief read history file, lines are 'suite<TAB>test<TAB>nanoseconds<TAB>pass|fail'. 
+            * lines without a result count as passed. a missing file is not an error
+            */
+            void load(const std::string& path)
+            {
+                std::ifstream file(path);
+                std::string line;
+                while (std::getline(file, line))
+                {
+                    bool failed = false;
+                    auto ind = line.rfind('\t');
+                    if (ind != line.npos && (line.compare(ind + 1, line.npos, "pass") == 0 || line.compare(ind + 1, line.npos, "fail") == 0))
+                    {
+                        failed = line[ind + 1] == 'f';
+                        line.resize(ind);
+                        ind = line.rfind('\t');
+                    }
+                    if (ind == line.npos || line.find('\t') == ind) continue;
+
+                    long long ns = 0;
+                    auto [end, ec] = std::from_chars(line.data() + ind + 1, line.data() + line.size(), ns);
+                    if (ec != std::errc()) continue;
+
+                    entries[line.substr(0, ind)] = { std::chrono::nanoseconds(ns), failed };
+                }
+            }
+
+            /**
+            * @brief write history file, sorted by key so the file diffs cleanly
+            */
+            void save(const std::string& path) const
+            {
+                std::vector<const std::pair<const std::string, entry>*> sorted;
+                for (const auto& item : entries) sorted.push_back(&item);
+                std::sort(sorted.begin(), sorted.end(),
+                    [](const auto* a, const auto* b) { return a->first < b->first; });
+
+                std::ofstream file(path, std::ios::trunc);
+                for (const auto* item : sorted)
+                {
+                    file << item->first << '\t' << item->second.duration.count() << '\t' << (item->second.failed ? "fail" : "pass") << '\n';
+                }
+            }
+        };
+
+        /**
+        * @brief message that is printed on help command
+        */
+        inline const char* help_message =
+            "Print help\n"
+            "    ./tests --help\n"
+            "    ./tests -h\n"
+            "\n"
+            "Run all tests. Any include tags are ignored\n"
+            "    ./tests\n"
+            "    ./tests -a\n"
+            "    ./tests --all\n"
+            "\n"
+            "Run specific suites \n"
+            "(comma-separated, spaces around commas are ignored)\n"
+            "    ./tests --suites=\"database, math vec\"\n"
+            "    ./tests -s \"database, math vec\"\n"
+            "\n"
+            "Filter by tags (exclude with '!')\n"
+            "    ./tests --tags=\"fast, !network\"\n"
+            "    ./tests -t \"fast, !network\"\n"
+            "\n"
+            "Filter by a tag expression with '&', '|', '!' and parentheses\n"
+            "    ./tests --tags=\"(fast & db) | (smoke & !network)\"\n"
+            "\n"
+            "Print how many tests the filters select, without running them\n"
+            "    ./tests --tags=\"fast & !flaky\" --dry-run\n"
+            "\n"
+            "Run tests by id, a stable hash of 'suite::test' (listed with --list --reporter=jsonl).\n"
+            "Suite and tag filters do not apply\n"
+            "    ./tests --run-id=\"8c4f0a1e2b3d4c5f\"\n"
+            "\n"
+            "List all available tags\n"
+            "    ./tests --list\n"
+            "    ./tests -l\n"
+            "\n"
+            "Combine to apply filter to specific suites\n"
+            "    ./tests --suites=\"database\" --tags=\"!fast\"\n"
+            "\n"
+            "Stop after the first failed test, or after N of them. Tests not\n"
+            "started yet are cancelled and listed in the summary\n"
+            "    ./tests --fail-fast\n"
+            "    ./tests --fail-fast=5\n"
+            "\n"
+            "Run tests on N worker threads (0 = one per hardware thread)\n"
+            "    ./tests --jobs=8\n"
+            "    ./tests -j 8\n"
+            "\n"
+            "Check every property test on 10000 generated cases, with the seed\n"
+            "a failure printed to reproduce it (random per run by default)\n"
+            "    ./tests --property-cases=10000 --seed=42\n"
+            "\n"
+            "Replay fuzz test inputs from <dir>/<suite>/<test> (default ./corpus)\n"
+            "    ./tests --corpus=\"fuzz/corpus\"\n"
+            "\n"
+            "Run tests in separate worker processes, so a crash or a failed\n"
+            "require only fails the test that caused it (posix only)\n"
+            "    ./tests --isolate -j 8\n"
+            "\n"
+            "Measure hardware counters (cycles, instructions, cache and branch misses)\n"
+            "and rusage of every test and benchmark, shown per suite (linux only)\n"
+            "    ./tests --perf\n"
+            "    ./tests --bench --perf\n"
+            "\n"
+            "Fail tests running longer than N milliseconds, unless they set their own\n"
+            "timeout. Hung tests are named while they hang, with --isolate their worker is killed\n"
+            "    ./tests --timeout=60000 --isolate\n"
+            "\n"
+            "Report as JUnit XML, JSON Lines or TAP instead of the console output,\n"
+            "to stdout or to a file. With a file, the console output stays on stdout\n"
+            "    ./tests --reporter=junit --out=\"report.xml\"\n"
+            "    ./tests --reporter=jsonl\n"
+            "\n"
+            "Print only progress and a short summary\n"
+            "    ./tests --quiet\n"
+            "    ./tests -q\n"
+            "\n"
+            "Write test output in batches on a separate thread. This is always\n"
+            "on with more than one job, except with --isolate or --bench\n"
+            "    ./tests --async-output\n"
+            "\n"
+            "Run benchmarks instead of tests, suite and tag filters apply.\n"
+            "Benchmarks always run one at a time\n"
+            "    ./tests --bench\n"
+            "    ./tests --bench --suites=\"parser\" --tags=\"!slow\"\n"
+            "\n"
+            "Save benchmark results (google-benchmark json), and compare a later\n"
+            "run against them. A benchmark fails if its median is slower by more\n"
+            "than the threshold (5% by default) and the slowdown is significant\n"
+            "    ./tests --bench --bench-out=\"baseline.json\"\n"
+            "    ./tests --bench --baseline=\"baseline.json\" --threshold=10\n"
+            "\n"
+            "List the N slowest tests at the end of the summary\n"
+            "    ./tests --slowest=10\n"
+            "\n"
+            "Run one of N disjoint shards of the selected tests (0-based index).\n"
+            "Tests are split by a stable hash of 'suite::test', or balanced by\n"
+            "recorded durations if every shard uses the same history file.\n"
+            "Sharded runs only read the history file, so it stays the same for all shards\n"
+            "    ./tests --shard=0/4\n"
+            "    ./tests --shard=0/4 --shard-by=duration\n"
+            "\n"
+            "Test durations are kept in '.dough_history' so parallel runs\n"
+            "can start the longest tests first. Change the file or turn it off\n"
+            "    ./tests --history=\"build/durations.txt\"\n"
+            "    ./tests --history=\n"
+            "\n"
+            "The history file also keeps whether each test passed. Run the\n"
+            "tests that failed last time first, or only those\n"
+            "    ./tests --failed-first\n"
+            "    ./tests --last-failed\n"
+            "\n"
+            "If a command to run tests is combined with --help or --list,\n"
+            "the latter takes priority. E.g., here only the help will be \n"
+            "prined, but no tests will run\n"
+            "    ./tests --all --help\n"
+            "\n"
+            "If both --help and --list are used, the first command listed\n"
+            "takes priority. Here, only --list will be executed\n"
+            "    ./tests --list --help\n";
+
+        /**
+        * @brief trim string from the left
+        */
+        inline void trim_l(std::string& s) 
+        {
+            s.erase(s.begin(), std::find_if(s.begin(), s.end(), 
+                [](unsigned char ch) { return !std::isspace(ch); }));
+        }
+
+        /**
+        * @brief trim string from the right
+        */
+        inline void trim_r(std::string& s)
+        {
+            s.erase(std::find_if(s.rbegin(), s.rend(), 
+                [](unsigned char ch) { return !std::isspace(ch); }).base(), s.end());
+        }
+
+        /**
+        * @brief trim string from both sides
+        */
+        inline void trim(std::string& s) 
+        {
+            trim_l(s);
+            trim_r(s);
+        }
+
+        /**
+        * @struct cli_command
+        * @brief parsed cli command
+        */
+        struct cli_command
+        {
+            std::unordered_set<std::string> inc_tags;
+            std::unordered_set<std::string> exc_tags;
+            std::string tag_expr;
+            std::vector<std::uint64_t> ids;
+            std::string error_msg;
+            std::vector<std::string> suites;
+            std::string history = ".dough_history";
+            bool failed_first = false;
+            bool last_failed = false;
+            unsigned jobs = 1;
+            unsigned slowest = 0;
+            std::uint64_t seed = 0;
+            std::uint64_t property_cases = 100;
+            std::string corpus = "corpus";
+            std::uint64_t timeout = 0;
+            std::uint64_t fail_fast = 0;
+            bool perf = false;
+            unsigned shard_index = 0;
+            unsigned shard_count = 1;
+            bool shard_by_duration = false;
+            bool isolate = false;
+            bool async_output = false;
+            std::string reporter = "console";
+            std::string out;
+            bool quiet = false;
+            bool bench = false;
+            bool list = false;
+            bool dry_run = false;
+            std::string bench_out;
+            std::string bench_baseline;
+            double bench_threshold = 0.05;
+            bool help = false;
+            bool run_all = false;
+        };
+
+        /**
+        * @brief format cli error
+        */
+        inline std::string cli_error_format(const std::string& str)
+        {
+            return std::format("[CLI  ] Error: {}", str);
+        }
+
+        /**
+        * @brief parse suites
+        */
+        inline void cli_parse_suites(cli_command& cmd, const std::string& value)
+        {
+            std::vector<std::string> suites;
+            std::stringstream sstr(value);
+            std::string part;
+            while (std::getline(sstr, part, ','))
+            {
+                trim(part);
+                cmd.suites.push_back(part);
+            }
+        }
+
+        /**
+        * @brief parse tags, either a list (include, exclude with '!') or an expression
+        * with '&', '|', '!' and parentheses. several expressions must all match
+        */
+        inline void cli_parse_tags(cli_command& cmd, const std::string& value)
+        {
+            if (value.find_first_of("&|()") != value.npos)
+            {
+                std::string error;
+                if (!tag_program::compile(value, error))
+                {
+                    cmd.error_msg = cli_error_format(error);
+                    return;
+                }
+                cmd.tag_expr = cmd.tag_expr.empty() ? value : std::format("({}) & ({})", cmd.tag_expr, value);
+                return;
+            }
+
+            std::stringstream sstr(value);
+            std::string part;
+            while (std::getline(sstr, part, ','))
+            {
+                trim(part);
+                if (part.starts_with('!')) cmd.exc_tags.insert(part.substr(1));
+                else cmd.inc_tags.insert(part);
+            }
+        }
+
+        /**
+        * @brief parse comma-separated test ids
+        */
+        inline void cli_parse_ids(cli_command& cmd, const std::string& value)
+        {
+            std::stringstream sstr(value);
+            std::string part;
+            while (std::getline(sstr, part, ','))
+            {
+                trim(part);
+                auto id = id_parse(part);
+                if (!id)
+                {
+                    cmd.error_msg = cli_error_format(
+                        std::format("invalid test id '{}', expected 16 hex digits", part));
+                    return;
+                }
+                cmd.ids.push_back(*id);
+            }
+        }
+
+        /**
+        * @brief parse worker count
+        */
+        inline void cli_parse_jobs(cli_command& cmd, const std::string& value)
+        {
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), cmd.jobs);
+            if (ec != std::errc() || end != value.data() + value.size())
+            {
+                cmd.error_msg = cli_error_format(
+                    std::format("invalid number of jobs '{}'", value));
+            }
+        }
+
+        /**
+        * @brief parse number of slowest tests to list
+        */
+        inline void cli_parse_slowest(cli_command& cmd, const std::string& value)
+        {
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), cmd.slowest);
+            if (ec != std::errc() || end != value.data() + value.size())
+            {
+                cmd.error_msg = cli_error_format(
+                    std::format("invalid number of slowest tests '{}'", value));
+            }
+        }
+
+        /**
+        * @brief parse a positive count, e.g. a seed. false on malformed input or 0
+        */
+        inline bool cli_parse_count(std::uint64_t& count, const std::string& value)
+        {
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+            return ec == std::errc() && end == value.data() + value.size() && count > 0;
+        }
+
+        /**
+        * @brief parse regression threshold in percent
+        */
+        inline void cli_parse_threshold(cli_command& cmd, const std::string& value)
+        {
+            double percent = 0;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), percent);
+            if (ec != std::errc() || end != value.data() + value.size() || percent < 0)
+            {
+                cmd.error_msg = cli_error_format(
+                    std::format("invalid regression threshold '{}', expected percent", value));
+                return;
+            }
+            cmd.bench_threshold = percent / 100;
+        }
+
+        /**
+        * @brief parse shard as 'index/count'
+        */
+        inline void cli_parse_shard(cli_command& cmd, const std::string& value)
+        {
+            auto slash = value.find('/');
+            const char* mid = value.data() + (slash == value.npos ? value.size() : slash);
+            const char* last = value.data() + value.size();
+
+            auto [index_end, index_ec] = std::from_chars(value.data(), mid, cmd.shard_index);
+            if (slash == value.npos || index_ec != std::errc() || index_end != mid)
+            {
+                cmd.error_msg = cli_error_format(
+                    std::format("invalid shard '{}', expected 'index/count'", value));
+                return;
+            }
+
+            auto [count_end, count_ec] = std::from_chars(mid + 1, last, cmd.shard_count);
+            if (count_ec != std::errc() || count_end != last || cmd.shard_count == 0 || cmd.shard_index >= cmd.shard_count)
+            {
+                cmd.error_msg = cli_error_format(
+                    std::format("invalid shard '{}', expected 'index/count' with index < count", value));
+            }
+        }
+
+        /**
+        * @brief parses cl args into a command
+        */
+        inline cli_command cli_parse(int argc, char** argv)
+        {
+            cli_command command;
+            std::vector<std::string> arguments(argv + 1, argv + argc);
+            size_t arg_size = arguments.size();
+
+            auto get_value = [&](const std::string& arg) -> std::optional<std::string>
+                {
+                    auto ind = arg.find('=');
+                    if (ind == arg.npos)
+                    {
+                        command.error_msg = cli_error_format(
+                            std::format("missing '=' when passing values in '{}'", arg));
+                        return std::nullopt;
+                    }
+                    return arg.substr(ind + 1);
+                };
+
+            if (arg_size == 0)
+            {
+                command.run_all = true;
+                return command; // run all if no args passed
+            }
+
+            for (size_t i = 0; i < arg_size; ++i)
+            {
+                if (arguments[i] == "-h" || arguments[i] == "--help")
+                {
+                    if (command.list) continue; // list overrides help if is first
+                    command.help = true;
+                    return command; // help overrides all other args
+                }
+
+                else if (arguments[i] == "-l" || arguments[i] == "--list")
+                {
+                    command.list = true; // keep parsing, the reporter applies to the list
+                }
+
+                else if (arguments[i] == "-s")
+                {
+                    if (i == arg_size - 1)
+                    {
+                        command.error_msg = cli_error_format("missing argument after '-s'");
+                        return command; // no reason to parse after the error
+                    }
+                    // pass the next arg since they are delim'ed by space: -s "suite"
+                    cli_parse_suites(command, arguments[++i]);
+                }
+                else if (arguments[i].starts_with("--suites"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_suites(command, value.value());
+                    else return command; // return with error from get_value
+                }
+
+                else if (arguments[i] == "-t")
+                {
+                    if (i == arg_size - 1)
+                    {
+                        command.error_msg = cli_error_format("missing argument after '-t'");
+                        return command; // no reason to parse after the error
+                    }
+                    cli_parse_tags(command, arguments[++i]);
+                    if (!command.error_msg.empty()) return command;
+                }
+                else if (arguments[i].starts_with("--tags"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_tags(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i] == "--dry-run")
+                {
+                    command.dry_run = true;
+                }
+
+                else if (arguments[i].starts_with("--run-id"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_ids(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i] == "-j")
+                {
+                    if (i == arg_size - 1)
+                    {
+                        command.error_msg = cli_error_format("missing argument after '-j'");
+                        return command; // no reason to parse after the error
+                    }
+                    cli_parse_jobs(command, arguments[++i]);
+                    if (!command.error_msg.empty()) return command;
+                }
+                else if (arguments[i].starts_with("--jobs"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_jobs(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i].starts_with("--seed"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value && !cli_parse_count(command.seed, value.value()))
+                    {
+                        command.error_msg = cli_error_format(std::format("invalid seed '{}'", value.value()));
+                        return command;
+                    }
+                }
+
+                else if (arguments[i].starts_with("--property-cases"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value && !cli_parse_count(command.property_cases, value.value()))
+                    {
+                        command.error_msg = cli_error_format(std::format("invalid number of property cases '{}'", value.value()));
+                        return command;
+                    }
+                }
+
+                else if (arguments[i].starts_with("--timeout"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value && !cli_parse_count(command.timeout, value.value()))
+                    {
+                        command.error_msg = cli_error_format(std::format("invalid timeout '{}', expected milliseconds", value.value()));
+                        return command;
+                    }
+                }
+
+                else if (arguments[i] == "--fail-fast")
+                {
+                    command.fail_fast = 1;
+                }
+
+                else if (arguments[i].starts_with("--fail-fast="))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value && !cli_parse_count(command.fail_fast, value.value()))
+                    {
+                        command.error_msg = cli_error_format(std::format("invalid number of failures '{}'", value.value()));
+                        return command;
+                    }
+                }
+
+                else if (arguments[i].starts_with("--corpus"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) command.corpus = value.value();
+                }
+
+                else if (arguments[i].starts_with("--slowest"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_slowest(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i].starts_with("--shard-by"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (!value) return command; // return with error from get_value
+
+                    if (value.value() == "duration") command.shard_by_duration = true;
+                    else if (value.value() == "hash") command.shard_by_duration = false;
+                    else
+                    {
+                        command.error_msg = cli_error_format(
+                            std::format("unknown shard mode '{}', expected 'hash' or 'duration'", value.value()));
+                        return command;
+                    }
+                }
+                else if (arguments[i].starts_with("--shard"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_shard(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i] == "--bench")
+                {
+                    command.bench = true;
+                }
+                else if (arguments[i].starts_with("--bench-out"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) command.bench_out = value.value();
+                    else return command; // return with error from get_value
+                }
+                else if (arguments[i].starts_with("--baseline"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) command.bench_baseline = value.value();
+                    else return command; // return with error from get_value
+                }
+                else if (arguments[i].starts_with("--threshold"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) cli_parse_threshold(command, value.value());
+                    if (!command.error_msg.empty()) return command;
+                }
+
+                else if (arguments[i] == "--isolate")
+                {
+                    command.isolate = true;
+                }
+
+                else if (arguments[i] == "--perf")
+                {
+                    command.perf = true;
+                }
+
+                else if (arguments[i] == "--async-output")
+                {
+                    command.async_output = true;
+                }
+
+                else if (arguments[i].starts_with("--reporter"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (!value) return command; // return with error from get_value
+
+                    if (value.value() == "console" || value.value() == "junit" ||
+                        value.value() == "jsonl" || value.value() == "tap") command.reporter = value.value();
+                    else
+                    {
+                        command.error_msg = cli_error_format(
+                            std::format("unknown reporter '{}', expected 'console', 'junit', 'jsonl' or 'tap'", value.value()));
+                        return command;
+                    }
+                }
+                else if (arguments[i].starts_with("--out"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) command.out = value.value();
+                    else return command; // return with error from get_value
+                }
+                else if (arguments[i] == "-q" || arguments[i] == "--quiet")
+                {
+                    command.quiet = true;
+                }
+
+                else if (arguments[i].starts_with("--history"))
+                {
+                    // get value from the same arg
+                    auto value = get_value(arguments[i]);
+                    if (value) command.history = value.value();
+                    else return command; // return with error from get_value
+                }
+
+                else if (arguments[i] == "--failed-first")
+                {
+                    command.failed_first = true;
+                }
+
+                else if (arguments[i] == "--last-failed")
+                {
+                    command.last_failed = true;
+                }
+
+                else if (arguments[i] == "-a" || arguments[i] == "--all")
+                {
+                    command.run_all = true;
+                    // no return to get exclude tags
+                }
+
+                else
+                {
+                    command.error_msg = cli_error_format(
+                        std::format("unknown argument {}", arguments[i]));
+                    return command;
+                }
+            }
+
+            return command;
+        }
+    }
+
+    /**
+    * @class registry
+    * @brief class that stores and runs tests, either individually or all at once
+    */
+    class registry
+    {
+    public:
+        /**
+        * @brief register a test suite
+        */
+        dough::suite& suite(std::string name) noexcept
+        {
+            auto& ns = suite_list.emplace_back(detail::sanitize_tag(name));
+            suite_index.try_emplace(ns.name(), suite_list.size() - 1);
+            return ns;
+        }
+
+        /**
+        * @brief find test by id in constant time, nullptr if there is none
+        */
+        const test* find(std::uint64_t id)
+        {
+            materialize_id(id);
+            index_ids();
+            auto it = id_index.find(id);
+            return it == id_index.end() ? nullptr : &suite_list[it->second.first].test_list[it->second.second];
+        }
+
+        /**
+        * @brief add a reporter that gets the events of every run next to the built-in one
+        */
+        registry& reporter(std::shared_ptr<dough::reporter> rep)
+        {
+            if (rep) reporter_list.push_back(std::move(rep));
+            return *this;
+        }
+
+        /**
+        * @brief the default registry. it runs the tests defined with DOUGH_TEST in 
+        * any translation unit, next to the suites registered on it
+        */
+        static registry& global()
+        {
+            static registry reg = []()
+                {
+                    registry global_reg;
+                    global_reg.static_tests = true;
+                    return global_reg;
+                }();
+            return reg;
+        }
+
+        /**
+        * @brief run all suites
+        */
+        void run()
+        {
+            materialize(options{}, detail::tag_filter({}, {}));
+            for (auto& st : suite_list)
+            {
+                st.run();
+            }
+        }
+
+        /**
+        * @brief run specific suite
+        */
+        void run(std::string_view suite_name)
+        {
+            options opts;
+            opts.suites.emplace_back(suite_name);
+            materialize(opts, detail::tag_filter({}, {}));
+
+            run_summary sum;
+            if (auto it = suite_index.find(suite_name); it != suite_index.end())
+            {
+                sum.stats.emplace_back(suite_list[it->second].name(), suite_list[it->second].run());
+                return;
+            }
+            detail::console().on_summary(sum);
+        }
+
+        /**
+        * @brief run specific test of specific suite
+        */
+        void run(std::string_view suite_name, std::string_view test_name)
+        {
+            materialize_id(detail::test_hash(suite_name, test_name));
+            if (auto it = suite_index.find(suite_name); it != suite_index.end()) suite_list[it->second].run(test_name);
+        }
+
+        /**
+        * @brief run tests with filtering by tag, exclude optional
+        */
+        void run(
+            const include_tags& inc_tags,
+            const exclude_tags& exc_tags = {})
+        {
+            run(options{}, inc_tags, exc_tags);
+        }
+
+        /**
+        * @brief run tests with filtering by tag, include optional
+        */
+        void run(
+            const exclude_tags& exc_tags,
+            const include_tags& inc_tags = {})
+        {
+            run(inc_tags, exc_tags);
+        }
+
+        /**
+        * @brief run tests of a specific suite with filtering by tag
+        */
+        void run(
+            const std::string& suite_name,
+            const include_tags& inc_tags = {},
+            const exclude_tags& exc_tags = {})
+        {
+            options opts;
+            opts.suites.push_back(suite_name);
+            run(opts, inc_tags, exc_tags);
+        }
+
+        /**
+        * @brief run tests with filtering by tag, using run options (worker count, suite selection)
+        */
+        void run(
+            const options& opts,
+            const include_tags& inc_tags = {},
+            const exclude_tags& exc_tags = {})
+        {
+            // filters are compiled against known tags, DOUGH_TEST tags must be known by then
+            if (static_tests)
+            {
+                for (auto* entry = detail::static_test::all().first; entry; entry = entry->next) entry->interned_tags();
+            }
+
+            // compile the filter and plan the whole run before anything executes
+            std::string error;
+            auto expr = detail::tag_program::compile(opts.tags, error);
+            if (!expr)
+            {
+                std::cerr << std::format("[DOUGH] Error: {}\n", error);
+                return;
+            }
+
+            detail::history hist;
+            if (!opts.history_file.empty()) hist.load(opts.history_file);
+
+            auto plan = select(opts, detail::tag_filter(inc_tags, exc_tags, std::move(*expr)));
+            if (opts.shard_count > 1) shard(plan, opts, hist);
+            if (!opts.bench && (opts.failed_first || opts.last_failed))
+            {
+                if (opts.history_file.empty()) detail::print_error("[DOUGH] Results of previous runs are not kept without a history file, running in the usual order\n");
+                else prioritize(plan, opts, hist);
+            }
+
+            if (opts.dry_run)
+            {
+                dry_run_print(plan, opts);
+                return;
+            }
+
+            auto rep = reporters(opts);
+            if (!rep) return;
 
-                st.run++;
-            }
-            summary_print(st);
-            return st;
+            size_t count = 0;
+            for (const auto& sel : plan) count += opts.bench ? sel.benches.size() : sel.tests.size();
+
+            // benchmarks keep the writer thread off their cores, isolated runs fork. 
+            // a run started from inside a test leaves the writer of the outer run alone
+            bool async = !opts.bench && !opts.isolate && (opts.async_output || detail::resolve_jobs(opts.jobs) > 1) &&
+                !detail::output::instance().async();
+            if (async) detail::output::instance().start();
+
+            if (opts.perf) detail::perf_probe();
+
+            rep->on_run_start(count);
+            auto start = std::chrono::steady_clock::now();
+            auto sum = opts.bench ? execute_benches(plan, opts, *rep) : execute(plan, opts, hist, *rep);
+            sum.wall = detail::since(start);
+            rep->on_summary(sum);
+
+            if (async) detail::output::instance().stop();
+
+            // shards split the tests by what they read from the history file, so it must not 
+            // change until every shard ran. sharded runs only read it
+            if (!opts.history_file.empty() && opts.shard_count <= 1) hist.save(opts.history_file);
         }
 
         /**
-        * @brief run specific test by name
+        * @brief run based on command line arguments
         */
-        void run(std::string_view name)
+        void run(int argc, char** argv)
         {
-            for (auto& test : test_list)
+            auto cmd = detail::cli_parse(argc, argv);
+            
+
+            if (!cmd.error_msg.empty())
             {
-                if (test.name() == name)
-                {
-                    if (setup_function) setup_function();
-                    test.run();
-                    if (teardown_function) teardown_function();
-                    return;
-                }
+                std::cerr << cmd.error_msg << '\n';
+                return;
             }
-        }
 
-        /**
-        * @brief run test with tag filtering. test runs if at leas one of required tags is present. test is excluded by the same logic
-        */
-        stats run(
-            const include_tags& inc_tags,
-            const exclude_tags& exc_tags = {})
-        {
-            stats st;
-            start_print();
-            for (auto& test : test_list)
+            if (cmd.help)
             {
-                // skip test with excluded tag
-                if (detail::uset_have_common(test.tags(), exc_tags.set)) continue;
+                std::cout << detail::help_message << '\n';
+                return;
+            }
 
-                // run if has at least one required tag or if no include tags are specified
-                if (inc_tags.set.empty() || detail::uset_have_common(test.tags(), inc_tags.set))
-                {
-                    if (setup_function) setup_function();
-                    if (test.run()) st.pass++;
-                    else
-                    {
-                        st.fail++;
-                        st.failed.push_back(test.name());
-                    }
-                    if (teardown_function) teardown_function();
+            options opts;
+            opts.reporter = cmd.reporter;
+            opts.out = cmd.out;
+            opts.quiet = cmd.quiet;
 
-                    st.run++;
-                }
+            if (cmd.list)
+            {
+                list_print(opts);
+                return;
             }
-            summary_print(st);
-            return st;
+
+            opts.jobs = cmd.jobs;
+            opts.slowest = cmd.slowest;
+            opts.seed = cmd.seed;
+            opts.property_cases = cmd.property_cases;
+            opts.timeout = std::chrono::milliseconds(cmd.timeout);
+            opts.fail_fast = static_cast<unsigned>(std::min<std::uint64_t>(cmd.fail_fast, std::numeric_limits<unsigned>::max()));
+            opts.corpus = cmd.corpus;
+            opts.history_file = cmd.history;
+            opts.failed_first = cmd.failed_first;
+            opts.last_failed = cmd.last_failed;
+            opts.isolate = cmd.isolate;
+            opts.perf = cmd.perf;
+            opts.async_output = cmd.async_output;
+            opts.bench = cmd.bench;
+            opts.bench_out = cmd.bench_out;
+            opts.bench_baseline = cmd.bench_baseline;
+            opts.bench_threshold = cmd.bench_threshold;
+            opts.shard_index = cmd.shard_index;
+            opts.shard_count = cmd.shard_count;
+            opts.shard_by_duration = cmd.shard_by_duration;
+            opts.dry_run = cmd.dry_run;
+            opts.ids = std::move(cmd.ids);
+
+            if (cmd.run_all)
+            {
+                run(opts, include_tags{}, exclude_tags{ cmd.exc_tags });
+                return;
+            }
+
+            opts.suites = std::move(cmd.suites);
+            opts.tags = std::move(cmd.tag_expr);
+            run(opts,
+                include_tags{ cmd.inc_tags },
+                exclude_tags{ cmd.exc_tags });
         }
 
     private:
         /**
-        * @brief print suite start message
+        * @struct selection
+        * @brief tests of one suite picked for a run
         */
-        void start_print()
+        struct selection
         {
-            std::stringstream sstr;
-            sstr << "[SUITE] " << suite_name << " started" << '\n';
-            std::cout << sstr.str();
-        }
+            dough::suite* owner = nullptr;
+            std::vector<test*> tests;
+            std::vector<bench*> benches;
+        };
 
         /**
-        * @brief print suite start message
+        * @brief pick suites and tests to run, in registration order
         */
-        void finish_print()
+        std::vector<selection> select(const options& opts, const detail::tag_filter& filter)
         {
-            std::stringstream sstr;
-            sstr << "[SUITE  ] " << suite_name << " finished" << '\n';
-            std::cout << sstr.str();
+            if (!opts.bench) materialize(opts, filter);
+            if (!opts.bench && !opts.ids.empty()) return select_ids(opts.ids);
+
+            std::unordered_set<std::string_view> requested(opts.suites.begin(), opts.suites.end());
+            std::vector<selection> plan;
+            for (auto& st : suite_list)
+            {
+                if (!requested.empty() && !requested.contains(st.name())) continue;
+
+                // skip suites with excluded tags
+                if (filter.excluded(*st.tag_set)) continue;
+
+                if (opts.bench) plan.push_back({ &st, {}, st.select_benches(filter) });
+                else plan.push_back({ &st, st.select(filter), {} });
+            }
+            return plan;
         }
 
         /**
-        * @brief prints suite run summary
+        * @brief add the DOUGH_TEST tests passing the filters to their suites, creating missing 
+        * suites. filtering runs on the descriptors, tests that are not selected are not made
         */
-        void summary_print(const stats& st)
+        void materialize(const options& opts, const detail::tag_filter& filter)
         {
-            if (st.run == 0) return;
+            if (!static_tests) return;
 
-            std::stringstream sstr;
-            sstr << "\n[=== SUITE: " << suite_name << " ===]\n" <<
-                "    Run      : " << st.run << '\n' <<
-                "    Pass     : " << st.pass << '\n' <<
-                "    Fail     : " << st.fail << '\n';
-            if (st.fail > 0)
+            std::unordered_set<std::string_view> requested(opts.suites.begin(), opts.suites.end());
+            for (auto* entry = detail::static_test::all().first; entry; entry = entry->next)
             {
-                sstr << "    Failures : \n";
-                for (int i = 0; i < st.failed.size(); ++i)
-                    sstr << "     - " << st.failed[i] << (i == st.failed.size() - 1 ? "" : "\n");
-            }
-            sstr << "\n\n";
-            std::cout << sstr.str();
-        }
+                if (entry->materialized) continue;
 
-    private:
-        std::unordered_set<std::string> tag_set;
-        std::function<void()> setup_function = nullptr;
-        std::function<void()> teardown_function = nullptr;
-        std::string suite_name;
-        std::vector<test> test_list;
-    };
+                // tests picked by id skip the other filters
+                if (!opts.ids.empty())
+                {
+                    if (std::find(opts.ids.begin(), opts.ids.end(), entry->id) != opts.ids.end()) suite_list[suite_at(entry->suite_name)].add(*entry);
+                    continue;
+                }
 
-    namespace detail
-    {
-        /**
-        * @brief message that is printed on help command
-        */
-        const char* help_message =
-            "Print help\n"
-            "    ./tests --help\n"
-            "    ./tests -h\n"
-            "\n"
-            "Run all tests. Any include tags are ignored\n"
-            "    ./tests\n"
-            "    ./tests -a\n"
-            "    ./tests --all\n"
-            "\n"
-            "Run specific suites \n"
-            "(comma-separated, spaces around commas are ignored)\n"
-            "    ./tests --suites=\"database, math vec\"\n"
-            "    ./tests -s \"database, math vec\"\n"
-            "\n"
-            "Filter by tags (exclude with '!')\n"
-            "    ./tests --tags=\"fast, !network\"\n"
-            "    ./tests -t \"fast, !network\"\n"
-            "\n"
-            "List all available tags\n"
-            "    ./tests --list\n"
-            "    ./tests -l\n"
-            "\n"
-            "Combine to apply filter to specific suites\n"
-            "    ./tests --suites=\"database\" --tags=\"!fast\"\n"
-            "\n"
-            "If a command to run tests is combined with --help or --list,\n"
-            "the latter takes priority. E.g., here only the help will be \n"
-            "prined, but no tests will run\n"
-            "    ./tests --all --help\n"
-            "\n"
-            "If both --help and --list are used, the first command listed\n"
-            "takes priority. Here, only --list will be executed\n"
-            "    ./tests --list --help\n";
+                if (!requested.empty() && !requested.contains(entry->suite_name)) continue;
+                auto& st = suite_list[suite_at(entry->suite_name)];
 
-        /**
-        * @brief trim string from the left
-        */
-        inline void trim_l(std::string& s) 
-        {
-            s.erase(s.begin(), std::find_if(s.begin(), s.end(), 
-                [](unsigned char ch) { return !std::isspace(ch); }));
+                const auto& own = entry->interned_tags();
+                if (filter.excluded(*st.tag_set) || filter.excluded(own)) continue;
+                if (!filter.included(*st.tag_set) && !filter.included(own)) continue;
+                if (!filter.matches(*st.tag_set, own)) continue;
+
+                st.add(*entry);
+            }
         }
 
         /**
-        * @brief trim string from the right
+        * @brief index of the suite with the given name, the suite is registered if there is none
         */
-        inline void trim_r(std::string& s)
+        size_t suite_at(std::string_view name)
         {
-            s.erase(std::find_if(s.rbegin(), s.rend(), 
-                [](unsigned char ch) { return !std::isspace(ch); }).base(), s.end());
+            if (auto it = suite_index.find(name); it != suite_index.end()) return it->second;
+
+            // registered names are sanitized, keep the raw one as an alias
+            auto sanitized = detail::sanitize_tag(std::string(name));
+            auto it = suite_index.find(sanitized);
+            size_t index = it != suite_index.end() ? it->second : (suite(std::move(sanitized)), suite_list.size() - 1);
+            suite_index.try_emplace(std::string(name), index);
+            return index;
         }
 
         /**
-        * @brief trim string from both sides
+        * @brief add the DOUGH_TEST test with the given id to its suite, if there is one
         */
-        inline void trim(std::string& s) 
+        void materialize_id(std::uint64_t id)
         {
-            trim_l(s);
-            trim_r(s);
+            options opts;
+            opts.ids.push_back(id);
+            materialize(opts, detail::tag_filter({}, {}));
         }
 
         /**
-        * @struct cli_command
-        * @brief parsed cli command
+        * @brief add tests registered since the last call to the id index.
+        * suites only ever grow, so only the new tail of each is visited
         */
-        struct cli_command
+        void index_ids()
         {
-            std::unordered_set<std::string> inc_tags;
-            std::unordered_set<std::string> exc_tags;
-            std::string error_msg;
-            std::vector<std::string> suites;
-            bool list = false;
-            bool help = false;
-            bool run_all = false;
-        };
+            indexed_tests.resize(suite_list.size(), 0);
+            for (size_t s = 0; s < suite_list.size(); ++s)
+            {
+                const auto& tests = suite_list[s].test_list;
+                for (size_t t = indexed_tests[s]; t < tests.size(); ++t)
+                {
+                    id_index.try_emplace(tests[t].id(), s, t);
+                }
+                indexed_tests[s] = tests.size();
+            }
+        }
 
         /**
-        * @brief format cli error
+        * @brief plan a run of the tests with the given ids, in registration order
         */
-        std::string cli_error_format(const std::string& str)
+        std::vector<selection> select_ids(const std::vector<std::uint64_t>& ids)
         {
-            return std::format("[CLI  ] Error: {}", str);
+            index_ids();
+
+            std::vector<std::pair<size_t, size_t>> found;
+            for (auto id : ids)
+            {
+                auto it = id_index.find(id);
+                if (it == id_index.end())
+                {
+                    std::cerr << std::format("[DOUGH] Error: no test with id '{}'\n", detail::id_format(id));
+                    continue;
+                }
+                found.push_back(it->second);
+            }
+            std::sort(found.begin(), found.end());
+            found.erase(std::unique(found.begin(), found.end()), found.end());
+
+            std::vector<selection> plan;
+            for (auto [s, t] : found)
+            {
+                if (plan.empty() || plan.back().owner != &suite_list[s]) plan.push_back({ &suite_list[s], {}, {} });
+                plan.back().tests.push_back(&suite_list[s].test_list[t]);
+            }
+            return plan;
         }
 
         /**
-        * @brief parse suites
+        * @brief print the number of selected tests per suite, without running them
         */
-        void cli_parse_suites(cli_command& cmd, const std::string& value)
+        void dry_run_print(const std::vector<selection>& plan, const options& opts) const
         {
-            std::vector<std::string> suites;
-            std::stringstream sstr(value);
-            std::string part;
-            while (std::getline(sstr, part, ','))
+            const char* kind = opts.bench ? "benchmark" : "test";
+            size_t selected = 0,
+                total = 0,
+                suites = 0;
+            std::stringstream sstr;
+            for (const auto& sel : plan)
             {
-                trim(part);
-                cmd.suites.push_back(part);
+                size_t count = opts.bench ? sel.benches.size() : sel.tests.size();
+                if (count == 0) continue;
+                sstr << std::format("[DRY  ] {} :: {} {}{}\n", sel.owner->name(), count, kind, count == 1 ? "" : "s");
+                selected += count;
+                ++suites;
+            }
+            for (const auto& st : suite_list) total += opts.bench ? st.benches().size() : st.tests().size();
+            if (static_tests && !opts.bench)
+            {
+                for (auto* entry = detail::static_test::all().first; entry; entry = entry->next)
+                {
+                    if (!entry->materialized) ++total;
+                }
             }
+
+            sstr << std::format("[DOUGH] Dry run: {} of {} {}{} selected in {} suite{}, nothing was run\n",
+                selected, total, kind, total == 1 ? "" : "s", suites, suites == 1 ? "" : "s");
+            std::cout << sstr.str();
         }
 
         /**
-        * @brief parse tags
+        * @brief keep only the tests of shard opts.shard_index. by default a test belongs to 
+        * test_hash % shard_count; when balancing by duration, tests are spread longest first 
+        * over the least loaded shard, which is deterministic as long as every shard reads 
+        * the same history file. sharded runs do not write it for that reason. 
+        * tests without history keep their hash shard
         */
-        void cli_parse_tags(cli_command& cmd, const std::string& value)
+        static void shard(std::vector<selection>& plan, const options& opts, const detail::history& hist)
         {
-            std::vector<std::string> suites;
-            std::stringstream sstr(value);
-            std::string part;
-            while (std::getline(sstr, part, ','))
+            struct candidate
             {
-                trim(part);
-                if (part.starts_with('!')) cmd.exc_tags.insert(part.substr(1));
-                else cmd.inc_tags.insert(part);
+                std::uint64_t hash;
+                long long duration;
+                test* tst;
+            };
+
+            std::vector<candidate> candidates;
+            long long known_total = 0;
+            size_t known_count = 0;
+            for (const auto& sel : plan)
+            {
+                for (auto* tst : sel.tests)
+                {
+                    auto duration = opts.shard_by_duration ? hist.find(sel.owner->name(), tst->name()) : std::nullopt;
+                    candidates.push_back({ tst->id(), duration ? duration->count() : -1, tst });
+                    if (duration)
+                    {
+                        known_total += duration->count();
+                        known_count++;
+                    }
+                }
+            }
+
+            std::unordered_set<const test*> keep;
+            std::vector<long long> load(opts.shard_count, 0);
+            long long estimate = known_count > 0 ? known_total / static_cast<long long>(known_count) : 0;
+
+            for (const auto& c : candidates)
+            {
+                if (c.duration >= 0) continue;
+                auto index = static_cast<unsigned>(c.hash % opts.shard_count);
+                load[index] += estimate;
+                if (index == opts.shard_index) keep.insert(c.tst);
+            }
+
+            std::sort(candidates.begin(), candidates.end(), [](const candidate& a, const candidate& b)
+                {
+                    return a.duration != b.duration ? a.duration > b.duration : a.hash < b.hash;
+                });
+            for (const auto& c : candidates)
+            {
+                if (c.duration < 0) break;
+                auto index = static_cast<unsigned>(std::min_element(load.begin(), load.end()) - load.begin());
+                load[index] += c.duration;
+                if (index == opts.shard_index) keep.insert(c.tst);
+            }
+
+            for (auto& sel : plan)
+            {
+                std::erase_if(sel.tests, [&](const test* tst) { return !keep.contains(tst); });
             }
         }
 
         /**
-        * @brief parses cl args into a command
+        * @brief run selected tests, on a worker pool if more than one job is requested
+        * or in worker processes if isolation is on. on the pool, a suite with setup or teardown 
+        * keeps its tests on one worker unless it is parallel(). measured durations are written 
+        * back to hist. with options::fail_fast, tests not started by the time the limit is reached are cancelled
         */
-        cli_command cli_parse(int argc, char** argv)
+        run_summary execute(const std::vector<selection>& plan, const options& opts, detail::history& hist, dough::reporter& rep)
         {
-            cli_command command;
-            std::vector<std::string> arguments(argv + 1, argv + argc);
-            size_t arg_size = arguments.size();
-
-            auto get_value = [&](const std::string& arg) -> std::optional<std::string>
-                {
-                    auto ind = arg.find('=');
-                    if (ind == arg.npos)
-                    {
-                        command.error_msg = cli_error_format(
-                            std::format("missing '=' when passing values in '{}'", arg));
-                        return std::nullopt;
-                    }
-                    return arg.substr(ind + 1);
-                };
+            run_summary sum;
+            unsigned jobs = detail::resolve_jobs(opts.jobs);
+            bool isolate = opts.isolate && DOUGH_POSIX;
 
-            if (arg_size == 0)
+            if (opts.isolate && !isolate)
             {
-                command.run_all = true;
-                return command; // run all if no args passed
+                detail::print_error("[DOUGH] Process isolation is not supported on this platform, running in-process\n");
             }
 
-            for (size_t i = 0; i < arg_size; ++i)
+            // a test runs its cases on its own worker, isolated workers do not start threads at all. 
+            // only the last test of a parallel run spreads them, see below
+            detail::run_context ctx{ 1, opts.seed ? opts.seed : detail::random_seed(), opts.property_cases, opts.corpus, opts.timeout };
+            ctx.perf = opts.perf;
+
+            // flatten the plan so workers are not held back by suite boundaries
+            std::vector<std::pair<dough::suite*, test*>> queue;
+            std::deque<detail::suite_session> sessions;
+            std::vector<detail::suite_session*> session_of;
+            for (const auto& sel : plan)
             {
-                if (arguments[i] == "-h" || arguments[i] == "--help")
+                auto& session = sessions.emplace_back(sel.owner->name(), sel.owner->once, sel.tests.size());
+                for (auto* tst : sel.tests)
                 {
-                    command.help = true;
-                    return command; // help overrides all other args
+                    queue.emplace_back(sel.owner, tst);
+                    session_of.push_back(&session);
                 }
+            }
 
-                else if (arguments[i] == "-l" || arguments[i] == "--list")
+            auto time_limit = [&](size_t i)
                 {
-                    command.list = true;
-                    return command; // list also overrides if is first
-                }
+                    auto limit = queue[i].second->timeout();
+                    return limit.count() > 0 ? limit : ctx.timeout;
+                };
 
-                else if (arguments[i] == "-s")
-                {
-                    if (i == arg_size - 1)
-                    {
-                        command.error_msg = cli_error_format("missing argument after '-s'");
-                        return command; // no reason to parse after the error
-                    }
-                    // pass the next arg since they are delim'ed by space: -s "suite"
-                    cli_parse_suites(command, arguments[++i]);
-                }
-                else if (arguments[i].starts_with("--suites"))
-                {
-                    // get value from the same arg
-                    auto value = get_value(arguments[i]);
-                    if (value) cli_parse_suites(command, value.value());
-                    else return command; // return with error from get_value
-                }
+            // in-process tests over their limit are named while they run, isolated workers are killed by the parent instead
+            std::optional<detail::watchdog> watch;
+            for (size_t i = 0; i < queue.size() && !isolate; ++i)
+            {
+                if (time_limit(i).count() <= 0) continue;
+                ctx.watch = &watch.emplace();
+                break;
+            }
 
-                else if (arguments[i] == "-t")
+            std::vector<detail::outcome> results(queue.size());
+            std::vector<char> ran(queue.size(), false); // written by the worker threads, so not vector<bool>
+            detail::failure_limit limit(opts.fail_fast);
+
+            if (jobs == 1 && !isolate)
+            {
+                size_t i = 0;
+                for (size_t k = 0; k < plan.size(); ++k)
                 {
-                    if (i == arg_size - 1)
-                    {
-                        command.error_msg = cli_error_format("missing argument after '-t'");
-                        return command; // no reason to parse after the error
+                    // suites reached after a stop are not started, their tests only count as cancelled
+                    const auto& sel = plan[k];
+                    suite::stats st;
+                    bool started = !limit.stopped();
+                    if (started) rep.on_suite_start(sel.owner->name());
+                    for (auto* tst : sel.tests)
+                    {
+                        if (limit.stopped()) st.cancelled.push_back(tst->name());
+                        else
+                        {
+                            results[i] = sel.owner->run_test(*tst, rep, sessions[k], ctx);
+                            ran[i] = true;
+                            limit.add(results[i].passed);
+                            st.add(tst->name(), results[i]);
+                        }
+                        ++i;
                     }
-                    cli_parse_tags(command, arguments[++i]);
+                    st.fixture_teardown = sessions[k].finish();
+                    if (started) rep.on_suite_end(sel.owner->name(), st);
+                    sum.stats.emplace_back(sel.owner->name(), std::move(st));
                 }
-                else if (arguments[i].starts_with("--tags"))
+            }
+            else
+            {
+#if DOUGH_POSIX
+                if (isolate)
                 {
-                    // get value from the same arg
-                    auto value = get_value(arguments[i]);
-                    if (value) cli_parse_tags(command, value.value());
-                    else return command; // return with error from get_value
+                    // workers only run the tests, the parent reports what they send back
+                    auto report = [&](size_t i, const detail::outcome& result, const detail::failure& fail)
+                        {
+                            rep.on_test_start(queue[i].first->name(), queue[i].second->name());
+                            rep.on_test_end(test_result(queue[i].first->name(), queue[i].second->name(), result, fail));
+                            ran[i] = true;
+                            limit.add(result.passed);
+                        };
+
+                    detail::isolated_for(schedule(queue, hist, opts.failed_first || opts.last_failed), jobs, results,
+                        [&](size_t i, std::string& payload)
+                        {
+                            detail::failure fail;
+                            auto result = queue[i].first->run_test(*queue[i].second, fail, *session_of[i], nullptr, ctx);
+                            detail::failure_write(payload, fail);
+                            return result;
+                        },
+                        [&](size_t i, const detail::outcome& result, std::string_view payload)
+                        {
+                            detail::failure fail;
+                            if (!detail::failure_read(payload, fail)) fail.error = "malformed result from worker";
+                            report(i, result, fail);
+                        },
+                        [&](size_t i, const std::string& reason, std::chrono::nanoseconds elapsed, bool timed_out)
+                        {
+                            detail::outcome result;
+                            result.wall = elapsed;
+                            result.timed_out = timed_out;
+                            detail::failure fail;
+                            fail.error = reason;
+                            fail.crashed = !timed_out;
+                            report(i, result, fail);
+                            return result;
+                        },
+                        time_limit,
+                        [&]() { return limit.stopped(); },
+                        [&]() { for (auto& session : sessions) session.finish(); });
                 }
-
-                else if (arguments[i] == "-a" || arguments[i] == "--all")
+                else
+#endif
                 {
-                    command.run_all = true;
-                    // no return to get exclude tags
+                    // cases spreading over every job on every worker would start jobs * jobs threads. 
+                    // once nothing is left to start, the last test takes the workers that went idle
+                    std::atomic<size_t> waiting = queue.size();
+                    std::atomic<unsigned> busy = 0;
+                    auto units = group(queue, session_of, schedule(queue, hist, opts.failed_first || opts.last_failed));
+                    std::vector<size_t> order(units.size());
+                    std::iota(order.begin(), order.end(), size_t(0));
+
+                    detail::parallel_for(order, jobs, [&](size_t u)
+                        {
+                            unsigned others = busy.fetch_add(1);
+                            for (size_t i : units[u])
+                            {
+                                if (limit.stopped()) break;
+
+                                detail::run_context local = ctx;
+                                if (waiting.fetch_sub(1) == 1) local.jobs = jobs - std::min(others, jobs - 1);
+
+                                results[i] = queue[i].first->run_test(*queue[i].second, rep, *session_of[i], local);
+                                ran[i] = true;
+                                limit.add(results[i].passed);
+                            }
+                            busy.fetch_sub(1);
+                        },
+                        limit.flag());
                 }
 
-                else
+                // merge in plan order so the summary does not depend on scheduling
+                size_t i = 0;
+                for (size_t k = 0; k < plan.size(); ++k)
                 {
-                    command.error_msg = cli_error_format(
-                        std::format("unknown argument {}", arguments[i]));
-                    return command;
+                    const auto& sel = plan[k];
+                    suite::stats st;
+                    for (auto* tst : sel.tests)
+                    {
+                        if (ran[i]) st.add(tst->name(), results[i]);
+                        else st.cancelled.push_back(tst->name());
+                        ++i;
+                    }
+                    // suites of a stopped run, or set up in-process by isolate's fallback, are torn down here
+                    st.fixture_teardown = sessions[k].finish();
+                    // like a serial run, a suite cancelled before any of its tests started is not reported
+                    if (st.run > 0 || st.cancelled.empty()) rep.on_suite_end(sel.owner->name(), st);
+                    sum.stats.emplace_back(sel.owner->name(), std::move(st));
                 }
             }
 
-            return command;
-        }
-    }
-
-    /**
-    * @class registry
-    * @brief class that stores and runs tests, either individually or all at once
-    */
-    class registry
-    {
-    public:
-        /**
-        * @brief register a test suite
-        */
-        dough::suite& suite(std::string name) noexcept
-        {
-            auto& ns = suite_list.emplace_back(detail::sanitize_tag(name));
-            return ns;
+            // cancelled tests keep their previous history
+            for (size_t i = 0; i < queue.size(); ++i)
+            {
+                if (ran[i]) hist.record(queue[i].first->name(), queue[i].second->name(), results[i].elapsed(), !results[i].passed);
+            }
+            return sum;
         }
 
         /**
-        * @brief run all suites
+        * @brief run selected benchmarks one at a time on the calling thread, 
+        * so they do not compete for cores with each other. 
+        * benchmarks that regressed against the baseline count as failed
         */
-        void run()
+        run_summary execute_benches(const std::vector<selection>& plan, const options& opts, dough::reporter& rep)
         {
-            for (auto& st : suite_list)
+            std::optional<std::unordered_map<std::string, std::vector<double>>> baseline;
+            if (!opts.bench_baseline.empty())
             {
-                st.run();
+                baseline = detail::baseline_read(opts.bench_baseline);
+                if (!baseline)
+                {
+                    detail::print_error(std::format("[DOUGH] Error: cannot read benchmark baseline '{}'\n", opts.bench_baseline));
+                }
             }
-        }
 
-        /**
-        * @brief run specific suite
-        */
-        void run(std::string_view suite_name)
-        {
-            summary sum;
-            for (auto& st : suite_list)
+            run_summary sum;
+            detail::failure_limit limit(opts.fail_fast);
+            for (const auto& sel : plan)
             {
-                if (st.name() == suite_name)
+                if (sel.benches.empty()) continue;
+
+                suite::stats st;
+                detail::suite_session session(sel.owner->name(), sel.owner->once, sel.benches.size());
+                bool started = !limit.stopped();
+                if (started) rep.on_suite_start(sel.owner->name());
+                for (auto* bch : sel.benches)
                 {
-                    sum.stats[st.name()] = st.run();
-                    return;
+                    if (limit.stopped())
+                    {
+                        st.cancelled.push_back(bch->name());
+                        continue;
+                    }
+                    rep.on_bench_start(sel.owner->name(), bch->name());
+
+                    bench_result result, base;
+                    detail::failure fail;
+                    auto outcome = sel.owner->run_bench(*bch, result, fail, session, opts.perf);
+
+                    bench_report report(sel.owner->name(), bch->name(), outcome, fail);
+                    if (outcome.passed)
+                    {
+                        report.result = &result;
+                        if (baseline) compare(*baseline, opts, report, base);
+                        outcome.passed = !report.regressed;
+                    }
+                    rep.on_bench_end(report);
+
+                    limit.add(outcome.passed);
+                    st.add(bch->name(), outcome);
+                    if (result.samples.size() > 0) st.benches.push_back(std::move(result));
                 }
+                st.fixture_teardown = session.finish();
+                if (started) rep.on_suite_end(sel.owner->name(), st);
+                sum.stats.emplace_back(sel.owner->name(), std::move(st));
             }
-            summary_print(sum);
-        }
 
-        /**
-        * @brief run specific test of specific suite
-        */
-        void run(std::string_view suite_name, std::string_view test_name)
-        {
-            for (auto& st : suite_list)
+            if (!opts.bench_out.empty())
             {
-                if (st.name() == suite_name)
+                std::vector<std::pair<std::string, const bench_result*>> results;
+                for (const auto& [name, st] : sum.stats)
                 {
-                    st.run(test_name);
-                    return;
+                    for (const auto& result : st.benches) results.emplace_back(name + "/" + result.name, &result);
                 }
+
+                std::ofstream file(opts.bench_out, std::ios::trunc);
+                if (file) detail::baseline_write(file, results);
+                else detail::print_error(std::format("[DOUGH] Error: cannot write benchmark results to '{}'\n", opts.bench_out));
             }
+            return sum;
         }
 
         /**
-        * @brief run tests with filtering by tag, exclude optional
+        * @brief compare benchmark samples against the baseline, the outcome goes into report.
+        * a regression is a median slowdown over the threshold that is also significant
         */
-        void run(
-            const include_tags& inc_tags,
-            const exclude_tags& exc_tags = {})
+        static void compare(
+            const std::unordered_map<std::string, std::vector<double>>& baseline,
+            const options& opts,
+            bench_report& report,
+            bench_result& base)
         {
-            summary sum;
-            for (auto& st : suite_list)
-            {
-                // skip suites with excluded tags
-                if (detail::uset_have_common(st.tags(), exc_tags.set)) continue;
+            report.compared = true;
+            report.threshold = opts.bench_threshold;
 
-                sum.stats[st.name()] = st.run(inc_tags, exc_tags);
-            }
-            summary_print(sum);
+            auto it = baseline.find(report.suite + "/" + report.name);
+            if (it == baseline.end() || it->second.empty()) return;
+
+            base.samples = it->second;
+            detail::bench_stats(base);
+
+            report.baseline = &base;
+            report.change = base.median > 0 ? (report.result->median - base.median) / base.median : 0.0;
+            report.p_value = detail::mann_whitney_p(base.samples, report.result->samples);
+            report.regressed = report.change > opts.bench_threshold && report.p_value < opts.bench_alpha;
         }
 
         /**
-        * @brief run tests with filtering by tag, include optional
+        * @brief order queued tests longest first by their previous duration (LPT), 
+        * tests without history follow in registration order. with failed_first, 
+        * tests that failed in the previous run start before all others
         */
-        void run(
-            const exclude_tags& exc_tags,
-            const include_tags& inc_tags = {})
+        static std::vector<size_t> schedule(
+            const std::vector<std::pair<dough::suite*, test*>>& queue,
+            const detail::history& hist,
+            bool failed_first = false)
         {
-            run(inc_tags, exc_tags);
+            std::vector<long long> known(queue.size(), -1);
+            std::vector<bool> failed(queue.size(), false);
+            for (size_t i = 0; i < queue.size(); ++i)
+            {
+                auto duration = hist.find(queue[i].first->name(), queue[i].second->name());
+                if (duration) known[i] = duration->count();
+                if (failed_first) failed[i] = hist.failed(queue[i].first->name(), queue[i].second->name());
+            }
+
+            std::vector<size_t> order(queue.size());
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(),
+                [&](size_t a, size_t b) { return failed[a] != failed[b] ? failed[a] : known[a] > known[b]; });
+            return order;
         }
 
         /**
-        * @brief run tests of a specific suite with filtering by tag
+        * @brief split the scheduled tests into the tasks of a parallel run: the tests of a serial() 
+        * suite make one task, in plan order, placed where the first of them was scheduled. 
+        * every other test is a task of its own
         */
-        void run(
-            const std::string& suite_name,
-            const include_tags& inc_tags = {},
-            const exclude_tags& exc_tags = {})
+        static std::vector<std::vector<size_t>> group(
+            const std::vector<std::pair<dough::suite*, test*>>& queue,
+            const std::vector<detail::suite_session*>& session_of,
+            const std::vector<size_t>& order)
         {
-            summary sum;
-            for (auto& st : suite_list)
+            std::vector<std::vector<size_t>> units;
+            std::unordered_map<const detail::suite_session*, size_t> unit_of;
+            for (size_t i : order)
             {
-                if (st.name() != suite_name) continue;
-
-                // skip suites with excluded tags
-                if (detail::uset_have_common(st.tags(), exc_tags.set)) continue;
-
-                sum.stats[st.name()] = st.run(inc_tags, exc_tags);
+                if (!queue[i].first->serial())
+                {
+                    units.push_back({ i });
+                    continue;
+                }
+                auto [it, added] = unit_of.try_emplace(session_of[i], units.size());
+                if (added) units.emplace_back();
+                units[it->second].push_back(i);
             }
-            summary_print(sum);
+
+            // the queue is in plan order
+            for (const auto& [session, u] : unit_of) std::sort(units[u].begin(), units[u].end());
+            return units;
         }
 
         /**
-        * @brief run based on command line arguments
+        * @brief put the tests that failed in the previous run first, and the suites holding them 
+        * before the others. with last_failed only those tests are kept, unless none of the 
+        * selected tests failed, then everything runs
         */
-        void run(int argc, char** argv)
+        static void prioritize(std::vector<selection>& plan, const options& opts, const detail::history& hist)
         {
-            auto cmd = detail::cli_parse(argc, argv);
-            
+            auto failed = [&](const selection& sel, const test* tst) { return hist.failed(sel.owner->name(), tst->name()); };
 
-            if (!cmd.error_msg.empty())
+            bool any = false;
+            for (const auto& sel : plan)
             {
-                std::cerr << cmd.error_msg << '\n';
-                return;
+                any = any || std::any_of(sel.tests.begin(), sel.tests.end(), [&](const test* tst) { return failed(sel, tst); });
             }
-
-            if (cmd.help)
+            if (!any)
             {
-                std::cout << detail::help_message << '\n';
+                if (opts.last_failed) detail::print_error(std::format("[DOUGH] No failed tests recorded in '{}', running all selected tests\n", opts.history_file));
                 return;
             }
 
-            if (cmd.list)
+            if (opts.last_failed)
             {
-                list_print();
+                // suites left without tests are dropped, so their setup and teardown do not run
+                for (auto& sel : plan) std::erase_if(sel.tests, [&](const test* tst) { return !failed(sel, tst); });
+                std::erase_if(plan, [](const selection& sel) { return sel.tests.empty(); });
                 return;
             }
 
-            if (cmd.run_all)
+            for (auto& sel : plan)
             {
-                run(exclude_tags{ cmd.exc_tags });
-                return;
+                std::stable_partition(sel.tests.begin(), sel.tests.end(), [&](const test* tst) { return failed(sel, tst); });
             }
+            std::stable_partition(plan.begin(), plan.end(),
+                [&](const selection& sel) { return !sel.tests.empty() && failed(sel, sel.tests.front()); });
+        }
+
+        /**
+        * @brief reporters for a run: the one picked in opts, writing to opts.out or stdout, and the 
+        * user's. the console keeps reporting to stdout when another format goes to a file. 
+        * nullptr if the report file cannot be opened
+        */
+        std::unique_ptr<detail::reporter_set> reporters(const options& opts)
+        {
+            auto set = std::make_unique<detail::reporter_set>();
 
-            if (!cmd.suites.empty())
+            std::ostream* out = &std::cout;
+            if (!opts.out.empty())
             {
-                for (const auto& s : cmd.suites)
+                auto file = std::make_unique<std::ofstream>(opts.out, std::ios::trunc);
+                if (!*file)
                 {
-                    run(s,
-                        include_tags{ cmd.inc_tags },
-                        exclude_tags{ cmd.exc_tags });
+                    detail::print_error(std::format("[DOUGH] Error: cannot open report file '{}'\n", opts.out));
+                    return nullptr;
                 }
+                out = file.get();
+                set->keep(std::move(file));
+            }
+
+            if (opts.reporter == "console")
+            {
+                set->add(std::make_unique<console_reporter>(opts.slowest, opts.quiet, opts.out.empty() ? nullptr : out));
             }
             else
             {
-                run(include_tags{ cmd.inc_tags },
-                    exclude_tags{ cmd.exc_tags });
+                if (!opts.out.empty()) set->add(std::make_unique<console_reporter>(opts.slowest, opts.quiet));
+
+                if (opts.reporter == "junit") set->add(std::make_unique<junit_reporter>(*out));
+                else if (opts.reporter == "jsonl") set->add(std::make_unique<jsonl_reporter>(*out));
+                else if (opts.reporter == "tap") set->add(std::make_unique<tap_reporter>(*out));
+                else
+                {
+                    detail::print_error(std::format("[DOUGH] Error: unknown reporter '{}'\n", opts.reporter));
+                    return nullptr;
+                }
             }
+
+            for (auto& rep : reporter_list) set->add(*rep);
+            return set;
         }
 
-    private:
         /**
-        * @struct summary
-        * @brief whole run summary
+        * @brief prints a list of all registered tests
         */
-        struct summary
+        void list_print(const options& opts = {})
         {
-            std::unordered_map<std::string, suite::stats> stats;
-        };
+            // reporters list test objects, so every DOUGH_TEST test is made here
+            materialize(options{}, detail::tag_filter({}, {}));
+            if (auto rep = reporters(opts)) rep->on_list(suite_list);
+        }
 
-        /**
-        * @brief output whole summary
-        */
-        void summary_print(const summary& sum)
+    private:
+        std::vector<dough::suite> suite_list;
+        std::vector<std::shared_ptr<dough::reporter>> reporter_list;
+        std::unordered_map<std::string, size_t, detail::string_hash, std::equal_to<>> suite_index;  // first suite of each name
+        std::unordered_map<std::uint64_t, std::pair<size_t, size_t>> id_index;                      // test id to suite and test index
+        std::vector<size_t> indexed_tests;                                                          // tests of each suite in id_index
+        bool static_tests = false;      // gather DOUGH_TEST tests, only the global registry does
+    };
+}
+
+#ifdef DOUGH_TRACK_ALLOCATIONS
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace dough::detail
+{
+    /**
+    * @brief top bit of the kept size, set on blocks allocated during an alloc_pause
+    */
+    constexpr std::size_t alloc_uncounted = ~(std::numeric_limits<std::size_t>::max() >> 1);
+
+    /**
+    * @brief allocate size bytes aligned to align, with the size kept right before the block 
+    * so delete knows what it frees. nullptr if out of memory
+    */
+    inline void* tracked_alloc(std::size_t size, std::size_t align) noexcept
+    {
+        std::size_t header = std::max(align, alignof(std::max_align_t));
+        if (size > alloc_uncounted - 1 - 2 * header) return nullptr;  // the top bit of the kept size is a flag
+
+#if defined(_WIN32)
+        void* block = ::_aligned_malloc(size + header, header);
+#else
+        void* block = header == alignof(std::max_align_t) ?
+            std::malloc(size + header) :
+            std::aligned_alloc(header, (size + 2 * header - 1) / header * header);  // size must be a multiple of the alignment
+#endif
+        if (!block) return nullptr;
+
+        auto* user = static_cast<char*>(block) + header;
+        std::size_t kept = alloc_paused ? size | alloc_uncounted : size;
+        std::memcpy(user - sizeof(kept), &kept, sizeof(kept));
+        if (!alloc_paused) alloc_record(size);
+        return user;
+    }
+
+    inline void tracked_free(void* ptr, std::size_t align) noexcept
+    {
+        if (!ptr) return;
+
+        std::size_t header = std::max(align, alignof(std::max_align_t)), size = 0;
+        auto* user = static_cast<char*>(ptr);
+        std::memcpy(&size, user - sizeof(size), sizeof(size));
+        if (!(size & alloc_uncounted)) free_record(size);
+
+#if defined(_WIN32)
+        ::_aligned_free(user - header);
+#else
+        std::free(user - header);
+#endif
+    }
+
+    /**
+    * @brief allocate like operator new: retry through the new handler, throw if there is none
+    */
+    inline void* tracked_new(std::size_t size, std::size_t align)
+    {
+        while (true)
         {
-            if (sum.stats.size() == 0) return;
+            if (void* ptr = tracked_alloc(size, align)) return ptr;
+            auto handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
 
-            int run = 0,
-                pass = 0,
-                fail = 0;
-            std::stringstream failed;
+    static const bool alloc_tracking_installed = (alloc_tracking.store(true), true);
+}
 
-            for (const auto& [name, stat] : sum.stats)
-            {
-                if (stat.run == 0) continue;
+// replaced for the whole program, so the counters also see allocations made by other libraries
 
-                run += stat.run;
-                pass += stat.pass;
-                fail += stat.fail;
+void* operator new(std::size_t size) { return dough::detail::tracked_new(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return dough::detail::tracked_new(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t align) { return dough::detail::tracked_new(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return dough::detail::tracked_new(size, static_cast<std::size_t>(align)); }
 
-                for (int i = 0; i < stat.failed.size(); ++i)
-                {
-                    failed << "     - " << name << " :: " << stat.failed[i] << '\n';
-                }
-            }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return dough::detail::tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return dough::detail::tracked_alloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return dough::detail::tracked_alloc(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return dough::detail::tracked_alloc(size, static_cast<std::size_t>(align)); }
 
-            std::stringstream sstr;
-            sstr << "\n ---------------------------";
-            sstr << "\n[===== OVERALL SUMMARY =====]\n" <<
-                " ---------------------------\n" <<
-                "    Total    : " << run << '\n' <<
-                "    Passed   : " << pass << '\n' <<
-                "    Failed   : " << fail << '\n';
+void operator delete(void* ptr) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::size_t) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, std::size_t) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::align_val_t align) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
+void operator delete[](void* ptr, std::align_val_t align) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { dough::detail::tracked_free(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
+void operator delete[](void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept { dough::detail::tracked_free(ptr, static_cast<std::size_t>(align)); }
 
-            if (fail > 0)
-            {
-                sstr << "    Failures :\n" << failed.str();
-            }
-            else
-            {
-                if (run > 0) sstr << "[DOUGH] All tests passed";
-            }
+#endif
 
-            sstr << '\n';
-            std::cout << sstr.str();
+#ifdef DOUGH_FUZZ_MAIN
+
+namespace dough::detail
+{
+    /**
+    * @struct fuzz_target
+    * @brief the DOUGH_FUZZ_TEST a fuzzer build runs, and the input it is running
+    */
+    struct fuzz_target
+    {
+        static_test* entry = nullptr;
+        std::filesystem::path directory;                // corpus directory, failing inputs go to its regressions
+        std::span<const std::uint8_t> input;
+
+        static fuzz_target& instance() noexcept
+        {
+            static fuzz_target target;
+            return target;
         }
 
         /**
-        * @brief prints a list of all registeret tests
+        * @brief save the current input as a regression case
         */
-        void list_print()
+        void save() const
         {
-            for (const auto& st : suite_list)
-            {
-                // - suite name [ tag1, tag2 ]
-                std::cout << "\n- " << st.name();
-                if (st.tags().size() > 0)
-                {
-                    std::cout << " [ ";
-                    for (auto it = st.tags().begin(); it != st.tags().end(); ++it)
-                    {
-                        std::cout << (*it) << 
-                            (it != (--st.tags().end()) ? ", " : "");
-                    }
-                    std::cout << " ]";
-                }
-                std::cout << '\n';
+            auto path = fuzz_save(directory, input);
+            if (path.empty()) print_error(std::format("[FUZZ ] Error: cannot save failing input to '{}'\n", (directory / "regressions").string()));
+            else print_error(std::format("[FUZZ ] Saved failing input as '{}', test runs replay it\n", path.string()));
+        }
+    };
 
-                const auto tab = "    ";
-                if (st.tests().empty())
-                {
-                    std::cout << tab << "*no registered tests*";
-                }
-                else
-                {
-                    for (const auto& tst : st.tests())
-                    {
-                        std::cout << tab << "- " << tst.name();
-                        if (tst.tags().size() > 0)
-                        {
-                            std::cout << " [ ";
-                            for (auto it = tst.tags().begin(); it != tst.tags().end(); ++it)
-                            {
-                                std::cout << (*it) <<
-                                    (it != (--tst.tags().end()) ? ", " : "");
-                            }
-                            std::cout << " ]";
-                        }
-                        std::cout << '\n';
-                    }
-                }
+    /**
+    * @brief pick the fuzz test from --fuzz="suite::test" (or its id) or the DOUGH_FUZZ
+    * environment variable, and the corpus root from --corpus. libfuzzer passes flags 
+    * starting with '--' through. with a single fuzz test it is picked by default
+    */
+    inline void fuzz_select(int argc, char** argv)
+    {
+        std::string wanted = std::getenv("DOUGH_FUZZ") ? std::getenv("DOUGH_FUZZ") : "";
+        std::string corpus = "corpus";
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            if (arg.starts_with("--fuzz=")) wanted = arg.substr(7);
+            else if (arg.starts_with("--corpus=")) corpus = arg.substr(9);
+        }
 
-            }
-            std::cout << '\n';
+        auto& target = fuzz_target::instance();
+        std::vector<static_test*> fuzzers;
+        for (auto* entry = static_test::all().first; entry; entry = entry->next)
+        {
+            if (!entry->fuzz) continue;
+            fuzzers.push_back(entry);
+            auto name = std::format("{}::{}", entry->suite_name, entry->test_name);
+            if (name == wanted || id_parse(wanted) == entry->id) target.entry = entry;
         }
+        if (wanted.empty() && fuzzers.size() == 1) target.entry = fuzzers.front();
 
-    private:
-        std::vector<dough::suite> suite_list;
-    };
-}
\ No newline at end of file
+        if (!target.entry)
+        {
+            std::string known;
+            for (auto* entry : fuzzers) known += std::format("    --fuzz=\"{}::{}\"\n", entry->suite_name, entry->test_name);
+            print_error(std::format("[FUZZ ] Error: {}, pick one of\n{}",
+                wanted.empty() ? "no fuzz test selected" : std::format("no fuzz test '{}'", wanted), known));
+            std::exit(1);
+        }
+        target.directory = fuzz_directory(corpus, target.entry->suite_name, target.entry->test_name);
+    }
+
+    /**
+    * @brief run one input. a failed check or exception saves the input and aborts, 
+    * so the fuzzer reports it as a crash
+    */
+    inline int fuzz_one(const std::uint8_t* data, size_t size)
+    {
+        auto& target = fuzz_target::instance();
+        target.input = std::span<const std::uint8_t>(data, size);
+        try
+        {
+            target.entry->fuzz(target.input);
+            return 0;
+        }
+        catch (const test_fail& fail)
+        {
+            fail_print(fail);
+        }
+        catch (const std::exception& e)
+        {
+            print_error(std::format("[ERROR] Fuzz test '{}' threw an exception: {}\n", target.entry->test_name, e.what()));
+        }
+        catch (...)
+        {
+            print_error(std::format("[ERROR] Fuzz test '{}' threw an exception: unknown exception\n", target.entry->test_name));
+        }
+        target.save();
+        std::abort();
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+// set when the sanitizers are linked in, they call back before reporting a crash
+extern "C" void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+#endif
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    dough::detail::fuzz_select(*argc, *argv);
+#if defined(__GNUC__) || defined(__clang__)
+    if (__sanitizer_set_death_callback)
+    {
+        __sanitizer_set_death_callback([]() { dough::detail::fuzz_target::instance().save(); });
+    }
+#endif
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, size_t size)
+{
+    return dough::detail::fuzz_one(data, size);
+}
+
+#endif
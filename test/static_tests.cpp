@@ -0,0 +1,29 @@
+#include "../src/dough.hpp"
+
+using namespace dough;
+
+// tests defined here register themselves before main and run with registry::global()
+
+DOUGH_TEST("static", "no tags")
+{
+    check_equal(2 + 2, 4, "should NOT see this");
+}
+
+DOUGH_TEST("static", "with tags", "fast", "func")
+{
+    check_true(true, "should NOT see this");
+}
+
+DOUGH_TEST("checks", "joins a runtime suite", "func")
+{
+    check_near(0.1 + 0.2, 0.3, 1e-9, "should NOT see this");
+}
+
+// replays ./corpus/static/fuzz_bytes in test runs, the empty input if there is none.
+// its corpus is test/corpus, which the build copies next to the tests.
+// a -fsanitize=fuzzer build with DOUGH_FUZZ_MAIN defined fuzzes it
+DOUGH_FUZZ_TEST("static", "fuzz bytes", "fuzz")
+{
+    auto zeros = std::count(data.begin(), data.end(), std::uint8_t(0));
+    check_true(static_cast<size_t>(zeros) <= data.size(), "should NOT see this");
+}
@@ -1,5 +1,30 @@
+// replaces global new/delete for the whole program; define in exactly one TU
+#define DOUGH_TRACK_ALLOCATIONS
 #include "../src/dough.hpp"
 
+#include <memory_resource>
+
+// counts bytes allocated through it, to measure the footprint of tag storage
+struct counting_resource : std::pmr::memory_resource
+{
+    size_t bytes = 0;
+
+    void* do_allocate(size_t size, size_t align) override
+    {
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, align);
+    }
+    void do_deallocate(void* ptr, size_t size, size_t align) override
+    {
+        bytes -= size;
+        std::pmr::new_delete_resource()->deallocate(ptr, size, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
 int main(int argc, char** argv)
 {
     using namespace dough;
@@ -7,7 +32,8 @@ int main(int argc, char** argv)
     const std::string see{ "should see this" };
     const std::string no_see{ "should NOT see this" };
 
-    registry reg;
+    // the global registry also runs the DOUGH_TEST tests of static_tests.cpp
+    registry& reg = registry::global();
     
     reg.suite("checks")
         .tags("func")
@@ -63,6 +89,91 @@ int main(int argc, char** argv)
         .add(
             test("input")
             .func([]() { throw 1; })
+        )
+        .add(
+            test("bounded loop")
+            .timeout(std::chrono::seconds(1))
+            .func([]() {
+                // stops early instead of timing out on a slow machine
+                int rounds = 0;
+                while (rounds < 1000 && remaining_time() > std::chrono::nanoseconds::zero()) ++rounds;
+                })
+        );
+
+    // one result per case, spread over the worker threads with --jobs
+    reg.suite("params")
+        .tags("func")
+        .add(
+            test("square root")
+            .params(std::views::iota(0, 1'000'000), [](int i) {
+                check_equal(static_cast<int>(std::sqrt(static_cast<double>(i) * i)), i);
+                })
+        )
+        .add(
+            test("squares")
+            .params(std::views::iota(0, 100) | std::views::transform([](int i) { return std::pair{ i, i * i }; }),
+                [](int i, int square) { check_equal(square / (i == 0 ? 1 : i), i); })
+        )
+        .add(
+            test("divisible by 3")
+            .params([]() { return std::views::iota(1, 8); }, [](int i) {
+                check_equal(i % 3, 0, "cases 1, 2, 4, 5 and 7 fail");
+                })
+        );
+
+    // heap usage of every test is printed next to its result
+    reg.suite("allocations")
+        .tags("func")
+        .add(
+            test("reserved push_back")
+            .func([]() {
+                std::vector<int> values;
+                values.reserve(64);
+                check_max_allocations(0, [&]() { for (int i = 0; i < 64; ++i) values.push_back(i); });
+                })
+        )
+        .add(
+            test("leak")
+            .func([]() {
+                static std::unique_ptr<int> kept;
+                check_no_leaks([]() { kept = std::make_unique<int>(1); }, "kept outlives the call");
+                })
+        );
+
+    // the table is built once for the suite (once per worker thread with --jobs), not per test
+    struct square_table
+    {
+        std::vector<int> squares;
+        explicit square_table(int count) { for (int i = 0; i < count; ++i) squares.push_back(i * i); }
+    };
+
+    reg.suite("fixtures")
+        .tags("func")
+        .fixture<square_table>(1000)
+        .add(
+            test("first squares")
+            .func([](const square_table& table) { check_equal(table.squares[3], 9); })
+        )
+        .add(
+            test("last square")
+            .func([](const square_table& table) { check_equal(table.squares.back(), 999 * 999); })
+        );
+
+    // cases come from --seed, counterexamples are shrunk before they are reported
+    reg.suite("properties")
+        .tags("func")
+        .add(
+            property("reverse twice", gen<std::vector<int>>(), [](const std::vector<int>& values) {
+                auto reversed = values;
+                std::reverse(reversed.begin(), reversed.end());
+                std::reverse(reversed.begin(), reversed.end());
+                return reversed == values;
+                })
+        )
+        .add(
+            property("always sorted", gen<std::vector<int>>(), [](const std::vector<int>& values) {
+                check_true(std::is_sorted(values.begin(), values.end()), "shrinks to two elements");
+                })
         );
 
     /*
@@ -139,7 +250,260 @@ int main(int argc, char** argv)
             .func([&]() { })
         );
     
-    
+
+    // shards run one after another on one history file must still split the same way
+    reg.suite("sharding")
+        .tags("func")
+        .add(
+            test("every test in one shard")
+            .func([]() {
+                constexpr int suites = 4, tests = 6;
+                std::array<int, suites * tests> runs{};
+
+                registry sharded;
+                for (int i = 0; i < suites * tests; ++i)
+                {
+                    sharded.suite(std::format("suite {}", i / tests))
+                        .add(test(std::format("test {}", i % tests)).func([&runs, i]() { ++runs[i]; }));
+                }
+
+                // durations of an earlier run, unequal so that balancing has something to do
+                auto dir = std::filesystem::temp_directory_path();
+                options opts;
+                opts.history_file = (dir / "dough_shard_history").string();
+                opts.out = (dir / "dough_shard_report").string();
+                opts.shard_count = 3;
+                opts.shard_by_duration = true;
+                {
+                    std::ofstream file(opts.history_file, std::ios::trunc);
+                    for (int i = 0; i < suites * tests; ++i)
+                    {
+                        file << "suite " << i / tests << "\ttest " << i % tests << '\t' << (i * 7919 % 13 + 1) * 1000 << "\tpass\n";
+                    }
+                }
+
+                for (unsigned index = 0; index < opts.shard_count; ++index)
+                {
+                    opts.shard_index = index;
+                    sharded.run(opts);
+                }
+                std::filesystem::remove(opts.history_file);
+                std::filesystem::remove(opts.out);
+
+                check_equal(std::count(runs.begin(), runs.end(), 1), std::ptrdiff_t(suites * tests), "each test ran exactly once");
+                })
+        );
+
+    reg.suite("scheduling")
+        .tags("func")
+        .add(
+            test("suite with teardown stays on one worker")
+            .func([]() {
+                std::atomic<int> inside = 0, most = 0;
+
+                registry hooked;
+                auto& s = hooked.suite("hooked")
+                    .setup([&]() {
+                        int now = ++inside;
+                        for (int seen = most; now > seen && !most.compare_exchange_weak(seen, now);) {}
+                    })
+                    .teardown([&]() { --inside; });
+                for (int i = 0; i < 16; ++i)
+                {
+                    s.add(test(std::format("test {}", i)).func([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }));
+                }
+
+                options opts;
+                opts.jobs = 4;
+                opts.out = (std::filesystem::temp_directory_path() / "dough_scheduling_report").string();
+                hooked.run(opts);
+                std::filesystem::remove(opts.out);
+
+                check_equal(most.load(), 1, "no test ran between another one and its teardown");
+                })
+        )
+        .add(
+            test("previous failures start first")
+            .func([]() {
+                // the slow failure holds one worker, the other one must still take the failures next
+                const std::array<std::string, 7> names{ "slow", "fail 1", "fail 2", "pass 1", "pass 2", "pass 3", "pass 4" };
+                std::mutex started_mutex;
+                std::vector<std::string> started;
+
+                registry ordered;
+                auto& s = ordered.suite("ordered");
+                for (const auto& name : names)
+                {
+                    s.add(test(name).func([&, name]() {
+                        {
+                            std::lock_guard lock(started_mutex);
+                            started.push_back(name);
+                        }
+                        if (name == "slow") std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                        }));
+                }
+
+                auto dir = std::filesystem::temp_directory_path();
+                options opts;
+                opts.jobs = 2;
+                opts.failed_first = true;
+                opts.history_file = (dir / "dough_order_history").string();
+                opts.out = (dir / "dough_order_report").string();
+                {
+                    std::ofstream file(opts.history_file, std::ios::trunc);
+                    file << "ordered\tslow\t400000000\tfail\n"
+                        << "ordered\tfail 1\t1000\tfail\n"
+                        << "ordered\tfail 2\t1000\tfail\n";
+                    for (int i = 1; i <= 4; ++i) file << "ordered\tpass " << i << "\t" << i * 1000000 << "\tpass\n";
+                }
+                ordered.run(opts);
+                std::filesystem::remove(opts.history_file);
+                std::filesystem::remove(opts.out);
+
+                auto failures_done = std::find_if(started.begin(), started.end(), [](const std::string& name) { return name.starts_with("pass"); });
+                check_equal(std::count_if(started.begin(), failures_done, [](const std::string& name) { return !name.starts_with("pass"); }),
+                    std::ptrdiff_t(3), "failed tests start before passing ones");
+                })
+        );
+
+    // run with --bench: a passing check should cost about as much as the bare comparison
+    reg.suite("check overhead")
+        .tags("perf")
+        .add(
+            bench("bare ==")
+            .func([](bench_state& state) {
+                int a = 1, b = 1;
+                for (auto _ : state)
+                {
+                    do_not_optimize(a);
+                    do_not_optimize(b);
+                    bool equal = (a == b);
+                    do_not_optimize(equal);
+                }
+                })
+        )
+        .add(
+            bench("passing check_equal")
+            .func([](bench_state& state) {
+                int a = 1, b = 1;
+                for (auto _ : state)
+                {
+                    do_not_optimize(a);
+                    do_not_optimize(b);
+                    bool equal = check_equal(a, b, "only used on fail");
+                    do_not_optimize(equal);
+                }
+                })
+        );
+
+    // run with --bench: tag filtering over 100k tests, string sets with suite tags copied 
+    // into every test (the old layout) against interned bitsets referencing the suite tags
+    constexpr size_t tag_tests = 100'000;
+    const std::array<std::string_view, 8> tag_pool{ "fast", "slow", "db", "network", "smoke", "unit", "gpu", "flaky" };
+
+    // a test stores its own tag bits and a pointer to the tags of its suite
+    struct tagged
+    {
+        detail::tag_set own;
+        std::shared_ptr<const detail::tag_set> inherited;
+    };
+    auto interned_tests = [&]() -> std::pair<std::pmr::vector<tagged>, size_t>&
+        {
+            static counting_resource memory;
+            static std::pair<std::pmr::vector<tagged>, size_t> data{ std::pmr::vector<tagged>(&memory), 0 };
+            auto& tests = data.first;
+            if (tests.empty())
+            {
+                std::shared_ptr<detail::tag_set> suite_tags;
+                for (size_t i = 0; i < tag_tests; ++i)
+                {
+                    if (i % 1000 == 0)
+                    {
+                        suite_tags = std::allocate_shared<detail::tag_set>(std::pmr::polymorphic_allocator<>(&memory));
+                        detail::tags_insert(*suite_tags, "suite", "component " + std::to_string(i / 1000));
+                    }
+                    auto& test = tests.emplace_back(detail::tag_set{}, suite_tags);
+                    detail::tags_insert(test.own, std::string(tag_pool[i % tag_pool.size()]), std::string(tag_pool[i / 3 % tag_pool.size()]));
+                }
+                data.second = memory.bytes;
+            }
+            return data;
+        };
+
+    reg.suite("tag filter")
+        .tags("perf")
+        .add(
+            bench("string sets, 100k tests")
+            .func([&](bench_state& state) {
+                static counting_resource memory;
+                static std::pmr::vector<std::pmr::unordered_set<std::pmr::string>> tests(&memory);
+                if (tests.empty())
+                {
+                    for (size_t i = 0; i < tag_tests; ++i)
+                    {
+                        auto& tags = tests.emplace_back();
+                        tags.emplace("suite");
+                        tags.emplace("component " + std::to_string(i / 1000));
+                        tags.emplace(tag_pool[i % tag_pool.size()]);
+                        tags.emplace(tag_pool[i / 3 % tag_pool.size()]);
+                    }
+                }
+                const std::unordered_set<std::string> inc{ "fast", "smoke" }, exc{ "flaky" };
+                for (auto _ : state)
+                {
+                    size_t selected = 0;
+                    for (const auto& tags : tests)
+                    {
+                        auto any = [&](const auto& filter) {
+                            return std::any_of(filter.begin(), filter.end(),
+                                [&](const std::string& tag) { return tags.contains(std::pmr::string(tag, &memory)); });
+                            };
+                        if (!any(exc) && any(inc)) ++selected;
+                    }
+                    do_not_optimize(selected);
+                }
+                state.items(tag_tests);
+                state.counter("bytes/test", static_cast<double>(memory.bytes) / tag_tests);
+                })
+        )
+        .add(
+            bench("interned bitsets, 100k tests")
+            .func([&](bench_state& state) {
+                auto& [tests, bytes] = interned_tests();
+                for (auto _ : state)
+                {
+                    detail::tag_filter filter(inc("fast", "smoke"), exc("flaky"));
+                    size_t selected = 0;
+                    for (const auto& test : tests)
+                    {
+                        if (filter.excluded(*test.inherited) || filter.excluded(test.own)) continue;
+                        if (filter.included(*test.inherited) || filter.included(test.own)) ++selected;
+                    }
+                    do_not_optimize(selected);
+                }
+                state.items(tag_tests);
+                state.counter("bytes/test", static_cast<double>(bytes) / tag_tests);
+                })
+        )
+        .add(
+            bench("tag expression, 100k tests")
+            .func([&](bench_state& state) {
+                auto& [tests, bytes] = interned_tests();
+                for (auto _ : state)
+                {
+                    std::string error;
+                    detail::tag_filter filter(inc(), exc(),
+                        *detail::tag_program::compile("(fast & db) | (smoke & !network & !flaky)", error));
+                    size_t selected = 0;
+                    for (const auto& test : tests)
+                    {
+                        if (filter.matches(*test.inherited, test.own)) ++selected;
+                    }
+                    do_not_optimize(selected);
+                }
+                state.items(tag_tests);
+                })
+        );
 
     reg.run(argc, argv);
 